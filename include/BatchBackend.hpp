@@ -0,0 +1,52 @@
+// BatchBackend.hpp - predict / gate / correct for many trackers at once.
+#pragma once
+#include "Tracker.hpp"
+#include "Metrics.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/**
+ * Runs the filter and gating stages of a group of trackers, one frame
+ * each, in one go: between Tracker::begin() and associate() for
+ * predict_gate(), between associate() and finish() for correct().  The
+ * association itself stays on the host, per tracker.
+ *
+ * "cpu" calls each tracker's own predict / gate / correct, so a batch
+ * step is exactly a step().  "opencl" (CMake option TRACKER_OPENCL)
+ * packs every tracker's tracks and detections into one set of device
+ * buffers through OpenCV's T-API and runs one kernel launch per stage
+ * for the whole group; its labels match the CPU's up to rounding.
+ * Host <-> device copies are charged to metrics::Transfer and the
+ * launches to metrics::Kernel of the Registry passed in.
+ *
+ * Not thread-safe: keep one backend per thread.
+ */
+class BatchBackend
+{
+public:
+    virtual ~BatchBackend() = default;
+
+    virtual const char* name() const = 0;
+
+    virtual void predict_gate(Tracker* const* t, std::size_t n, metrics::Registry& m) = 0;
+    virtual void correct(Tracker* const* t, std::size_t n, metrics::Registry& m) = 0;
+};
+
+/**
+ * The backend a "cpu" | "opencl" request gets on this machine: "opencl"
+ * falls back to "cpu", with a note on stderr, when there is no usable
+ * OpenCL device (or none with fp64 for a double Tracker).  Throws
+ * std::invalid_argument for an unknown name or for "opencl" in a build
+ * without TRACKER_OPENCL.
+ */
+std::string resolve_backend(const std::string& name);
+
+/** A new backend for a name resolve_backend() returned. */
+std::unique_ptr<BatchBackend> make_backend(const std::string& name);
+
+/**
+ * One step of n trackers, each begun on its frame: predict / gate on b,
+ * associate per tracker, correct on b.  finish() is left to the caller.
+ */
+void step_batch(BatchBackend& b, Tracker* const* t, std::size_t n, metrics::Registry& m);
@@ -0,0 +1,118 @@
+#pragma once
+#include "FrameIO.hpp"
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/*
+ * Compact binary streams for detections ("TRKF") and labels ("TRKL").
+ * Little-endian, everything naturally aligned so a mapped file can be read
+ * in place.
+ *
+ *   file header   16 B   magic[4] | u16 version | u16 flags | u32 0 | u32 0
+ *   per frame     16 B   u32 bytes (whole record incl. this header)
+ *                        u32 count | i64 timestamp in microseconds
+ *                  8 B   u32 stream | u32 0     (only with flag_streams)
+ *                 then count records:
+ *     TRKF f64    32 B   f64 x, y, w, h           (identical to Detection)
+ *     TRKF f32    16 B   f32 x, y, w, h
+ *     TRKL f64    40 B   i32 id | u32 0 | f64 x, y, w, h
+ *     TRKL f32    20 B   i32 id | f32 x, y, w, h
+ *
+ * `bytes` lets readers skip frames without looking at the records.
+ */
+namespace bin {
+
+constexpr char          frames_magic[4] = {'T','R','K','F'};
+constexpr char          labels_magic[4] = {'T','R','K','L'};
+constexpr char          quant_magic[4]  = {'T','R','K','Q'};   // QuantLabels.hpp
+constexpr std::uint16_t version         = 1;
+constexpr std::uint16_t flag_f32        = 1u << 0;
+constexpr std::uint16_t flag_streams    = 1u << 1;   // per-frame stream id
+
+struct FileHeader  { char magic[4]; std::uint16_t version, flags; std::uint32_t reserved[2]; };
+struct FrameHeader { std::uint32_t bytes, count; std::int64_t ts_us; };
+struct StreamTag   { std::uint32_t stream, reserved; };
+static_assert(sizeof(FileHeader)  == 16, "binary layout");
+static_assert(sizeof(FrameHeader) == 16, "binary layout");
+static_assert(sizeof(StreamTag)   ==  8, "binary layout");
+static_assert(sizeof(Detection)   == 32, "Detection must be four packed doubles");
+
+enum class Kind { None, Frames, Labels, QuantLabels };
+
+/** Which binary stream (if any) the first bytes announce. */
+Kind sniff(const char* data, std::size_t size);
+Kind sniff_file(const std::string& path);
+
+} // namespace bin
+
+/**
+ * Reads a TRKF file in place.  f64 files are handed out as views straight
+ * into the mapping; f32 files are widened into a reused buffer.
+ */
+class BinaryFrameReader : public FrameSource
+{
+public:
+    explicit BinaryFrameReader(const std::string& path);
+
+    bool next(Frame& fr) override;
+    bool next_view(FrameView& v) override;
+
+    bool streams() const { return streams_; }
+
+private:
+    MappedFile  file_;
+    const char* p_;
+    const char* end_;
+    bool        f32_, streams_;
+};
+
+/** Writes a TRKF stream; `streams` adds the per-frame stream tag. */
+class BinaryFrameWriter
+{
+public:
+    explicit BinaryFrameWriter(std::ostream& out, bool f32 = false, bool streams = false);
+
+    void write(double ts, const Detection* dets, std::size_t n, std::uint32_t stream = 0);
+
+private:
+    std::ostream&     out_;
+    bool              f32_, streams_;
+    std::vector<char> buf_;
+};
+
+/** Writes a TRKL stream; `streams` adds the per-frame stream tag. */
+class BinaryLabelWriter : public LabelSink
+{
+public:
+    explicit BinaryLabelWriter(std::ostream& out, bool f32 = false, bool streams = false);
+
+    void write(double ts, const std::vector<Label>& labels) override
+    { write_stream(0, ts, labels); }
+    void write_stream(std::uint32_t stream, double ts, const std::vector<Label>& labels) override;
+    void finish() override;
+
+private:
+    std::ostream&     out_;
+    bool              f32_, streams_;
+    std::vector<char> buf_;
+};
+
+/** Reads a TRKL file in place. */
+class BinaryLabelReader
+{
+public:
+    explicit BinaryLabelReader(const std::string& path);
+
+    bool next(double& ts, std::vector<Label>& labels, std::uint32_t* stream = nullptr);
+
+    bool streams() const { return streams_; }
+
+private:
+    MappedFile  file_;
+    const char* p_;
+    const char* end_;
+    bool        f32_, streams_;
+};
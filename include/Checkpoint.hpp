@@ -0,0 +1,64 @@
+// Checkpoint.hpp - tracker snapshots on disk, resumed runs, chunked runs.
+#pragma once
+#include "FrameIO.hpp"
+#include "Tracker.hpp"
+#include "Metrics.hpp"
+#include "Config.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/** Write t.save() to path through path.tmp + rename, so a crash never
+ *  leaves a half-written checkpoint behind. */
+void save_checkpoint(const std::string& path, const Tracker& t);
+
+/** t.restore() from path; throws std::runtime_error naming the file. */
+void load_checkpoint(const std::string& path, Tracker& t);
+
+/**
+ * Drops every frame of `src` taken at or before `after` - the time() of a
+ * restored tracker - so a resumed run picks up at the first frame the
+ * checkpointed run had not stepped yet.
+ */
+class ResumeSource : public FrameSource
+{
+public:
+    ResumeSource(std::unique_ptr<FrameSource> src, double after)
+        : src_(std::move(src)), after_(after) {}
+
+    bool next(Frame& fr) override;
+    bool next_view(FrameView& v) override;
+
+private:
+    std::unique_ptr<FrameSource> src_;
+    double                       after_;
+};
+
+struct ChunkOptions
+{
+    unsigned    workers = 0;      // 0 = std::thread::hardware_concurrency()
+    std::size_t chunks  = 0;      // 0 = one per worker
+    std::size_t overlap = 16;     // frames before each chunk stepped to warm up its tracker
+
+    /** Defaults overridden by [pipeline] workers / chunks / overlap. */
+    static ChunkOptions from(const Config& cfg);
+};
+
+/**
+ * Splits the input into `chunks` runs of consecutive frames and tracks
+ * them in parallel, each from a copy of `prototype`.  Every chunk but the
+ * first starts `overlap` frames early; those warm-up frames are tracked
+ * by both neighbours, and a serial stitching pass maps each chunk's
+ * track ids onto its predecessor's by the detections the two share
+ * (latest shared frame first).  Ids not seen in the overlap get fresh
+ * ones, so ids stay unique and a track crossing a boundary keeps its id.
+ * They are not the numbers a serial run would assign.
+ *
+ * The whole input and its labels are held in memory.  Labels are written
+ * to sink in frame order once every chunk is done.  Returns #frames; the
+ * chunk trackers' metrics (overlap frames included) go into `m` when it
+ * is given, with the number of ids carried across boundaries as
+ * `stitched`.
+ */
+std::size_t run_chunked(FrameSource& src, const Tracker& prototype, LabelSink& sink,
+                        const ChunkOptions& opt = {}, metrics::Registry* m = nullptr);
@@ -0,0 +1,73 @@
+// Config.hpp - defaults.ini, parsed once, with typed lookups.
+#pragma once
+#include <map>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * `[section]` headers and `key = value` lines, read in one pass at
+ * startup.  Headers and values may carry a trailing `#` or `;` comment,
+ * lines starting with either are comments, and the first occurrence of a
+ * key wins.  A missing file is an empty config, so every lookup falls
+ * back to the caller's default.
+ *
+ * Typed lookups convert with std::from_chars (locale-independent) and
+ * throw std::invalid_argument naming the key when a value does not parse.
+ */
+class Config
+{
+public:
+    Config() = default;
+
+    static Config load(const std::string& path = "defaults.ini");
+    static Config parse(std::string_view text, std::string origin = "config");
+
+    /** Raw value of [sec] key, or nullptr. */
+    const std::string* find(const std::string& sec, const std::string& key) const;
+
+    bool has(const std::string& sec, const std::string& key) const { return find(sec, key) != nullptr; }
+
+    std::string get(const std::string& sec, const std::string& key,
+                    const std::string& fallback = "") const
+    {
+        const std::string* v = find(sec, key);
+        return v && !v->empty() ? *v : fallback;
+    }
+
+    /** [sec] key as a number or bool (true/false, on/off, yes/no, 1/0). */
+    template<class T, class = std::enable_if_t<std::is_arithmetic_v<T>>>
+    T get(const std::string& sec, const std::string& key, T fallback) const
+    {
+        read(sec, key, fallback);
+        return fallback;
+    }
+
+    /** Overwrite v from [sec] key if it is set (non-empty); true if it was. */
+    template<class T>
+    bool read(const std::string& sec, const std::string& key, T& v) const
+    {
+        const std::string* s = find(sec, key);
+        if (!s || s->empty()) return false;
+        if (!convert(*s, v)) bad_value(sec, key, *s);
+        return true;
+    }
+
+private:
+    static bool convert(const std::string& s, std::string& v) { v = s; return true; }
+    static bool convert(const std::string& s, bool& v);
+    static bool convert(const std::string& s, int& v);
+    static bool convert(const std::string& s, long& v);
+    static bool convert(const std::string& s, long long& v);
+    static bool convert(const std::string& s, unsigned& v);
+    static bool convert(const std::string& s, unsigned long& v);
+    static bool convert(const std::string& s, unsigned long long& v);
+    static bool convert(const std::string& s, float& v);
+    static bool convert(const std::string& s, double& v);
+
+    [[noreturn]] void bad_value(const std::string& sec, const std::string& key,
+                                const std::string& value) const;
+
+    std::string origin_ = "config";
+    std::map<std::string, std::map<std::string, std::string>> sections_;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+template<class T>
+struct BasicDetection
+{
+    T x, y, w, h;        // normalised
+};
+
+using Detection  = BasicDetection<double>;   // I/O, labels
+using DetectionF = BasicDetection<float>;
+
+// Numeric type of the tracking core: filter state, gating and assignment
+// costs (CMake option TRACKER_FLOAT).  Both precisions are always built;
+// this only picks which one Tracker / TrackStore name.  Timestamps, I/O
+// and the emitted labels stay double either way.
+#if defined(TRACKER_FLOAT) && TRACKER_FLOAT
+using tracker_real = float;
+#else
+using tracker_real = double;
+#endif
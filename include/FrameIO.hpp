@@ -0,0 +1,177 @@
+#pragma once
+#include "Tracker.hpp"
+#include "MappedFile.hpp"
+#include "iso_time.hpp"
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ───────────────── timestamps ───────────────────────────────────────
+// Thin wrappers over iso_time.hpp (no locale, no iostreams): parse_iso
+// throws std::runtime_error on anything but "YYYY-MM-DDTHH:MM:SS[.f...]",
+// format_iso writes microseconds.  Hot paths use iso::Formatter on a
+// char buffer instead.
+double      parse_iso (std::string_view s);
+std::string format_iso(double sec);
+
+// ───────────────── frames ───────────────────────────────────────────
+/** One input frame; `stream` is the optional per-frame camera id (0 if absent). */
+struct Frame { double ts; std::vector<Detection> dets; std::uint32_t stream = 0; };
+
+/** Borrowed frame; valid until the source's next call. */
+struct FrameView { double ts; const Detection* dets; std::size_t n; std::uint32_t stream = 0; };
+
+/** Anything that yields frames in order. */
+class FrameSource
+{
+public:
+    virtual ~FrameSource() = default;
+
+    /** Fill fr with the next frame; false at end of input. */
+    virtual bool next(Frame& fr) = 0;
+
+    /**
+     * Zero-copy variant.  Sources that can point into their own storage
+     * (mapped binary files) override this; the default decodes into an
+     * internal Frame.
+     */
+    virtual bool next_view(FrameView& v)
+    {
+        if (!next(scratch_)) return false;
+        v = {scratch_.ts, scratch_.dets.data(), scratch_.dets.size(), scratch_.stream};
+        return true;
+    }
+
+protected:
+    Frame scratch_;
+};
+
+/**
+ * Splits a JSON text stream into its top-level objects with a small brace
+ * scanner (string- and escape-aware).  Accepts the usual `[ {...}, {...} ]`
+ * file as well as back-to-back objects (one per line or otherwise).
+ */
+class JsonObjectStream
+{
+public:
+    explicit JsonObjectStream(std::istream& in) : in_(in) {}
+
+    /** Text of the next top-level object; false at end of input. */
+    bool next(std::string& obj);
+
+private:
+    std::istream& in_;
+};
+
+/**
+ * Pulls one frame at a time out of a JSON input without building a DOM for
+ * the whole file: only the current object is handed to nlohmann::json, so
+ * memory stays constant in the number of frames.
+ */
+class JsonFrameReader : public FrameSource
+{
+public:
+    explicit JsonFrameReader(std::istream& in) : objs_(in) {}
+
+    bool next(Frame& fr) override;
+
+private:
+    JsonObjectStream objs_;
+    std::string      buf_;          // text of the current object, reused
+};
+
+/**
+ * Zero-copy ingest: mmaps the input and parses the fixed frame schema
+ * (`timestamp`, `detections[{x,y,w,h}]`, optional `stream`) straight into Frame with
+ * std::from_chars and iso::decode – no DOM, no iostreams.  Unknown keys
+ * are skipped.  Same accepted layouts as JsonFrameReader.
+ */
+class MappedJsonFrameReader : public FrameSource
+{
+public:
+    explicit MappedJsonFrameReader(const std::string& path);
+
+    bool next(Frame& fr) override;
+
+private:
+    [[noreturn]] void fail(const char* what) const;
+    void        skip_ws();
+    void        expect(char c);
+    std::string_view string();
+    double      number();
+    void        skip_value();
+    void        detection(Detection& d);
+
+    MappedFile  file_;
+    const char* p_;
+    const char* end_;
+};
+
+/**
+ * Binary frame files (BinaryFormat.hpp) are recognised by their magic and
+ * always mapped.  For JSON, "stream" reads through an istream (works on
+ * pipes) and "mmap" maps the file and uses the hand-written parser.
+ */
+std::unique_ptr<FrameSource> open_frames(const std::string& path,
+                                         const std::string& ingest = "mmap");
+
+// ───────────────── outputs ──────────────────────────────────────────
+/** Per-frame label output. */
+class LabelSink
+{
+public:
+    virtual ~LabelSink() = default;
+
+    virtual void write(double ts, const std::vector<Label>& labels) = 0;
+
+    /** Labels of one frame of `stream` (multi-stream runs); sinks that do
+     *  not record streams drop the id. */
+    virtual void write_stream(std::uint32_t stream, double ts, const std::vector<Label>& labels)
+    { (void)stream; write(ts, labels); }
+
+    /** Close the stream; call once after the last frame. */
+    virtual void finish() = 0;
+};
+
+/**
+ * Writes the output array incrementally, one frame per write() call.
+ * Pretty is exactly the layout `std::setw(2) << json_array` used to
+ * produce.  Lines writes each frame as one compact object on its own line
+ * (JSON Lines, no enclosing array), so a reader can act on every line as
+ * it arrives.  Minified is the same array as Pretty with no whitespace at
+ * all (about 60% of its size).  With `streams` every object starts
+ * with its `stream` id.
+ */
+class JsonFrameWriter : public LabelSink
+{
+public:
+    enum class Layout { Pretty, Lines, Minified };
+
+    explicit JsonFrameWriter(std::ostream& out, bool streams = false, Layout layout = Layout::Pretty)
+        : out_(out), streams_(streams), layout_(layout) {}
+
+    void write(double ts, const std::vector<Label>& labels) override
+    { write_stream(0, ts, labels); }
+    void write_stream(std::uint32_t stream, double ts, const std::vector<Label>& labels) override;
+
+    /** Input-schema frame (`timestamp`, `detections`), for converters. */
+    void write_dets(double ts, const Detection* dets, std::size_t n,
+                    std::uint32_t stream = 0);
+
+    void finish() override;
+
+private:
+    void emit();                    // buf_ as the next array element
+    std::string_view stamp(double ts);   // ts formatted into ts_buf_
+
+    std::ostream& out_;
+    bool          streams_;
+    Layout        layout_;
+    std::size_t   count_ = 0;
+    std::string   buf_;
+    iso::Formatter clock_;
+    char          ts_buf_[iso::encoded_size];
+};
@@ -0,0 +1,84 @@
+// LiveServer.hpp - track frames as they arrive on stdin or a socket.
+#pragma once
+#include "Tracker.hpp"
+#include "Metrics.hpp"
+#include "Overload.hpp"
+#include "Config.hpp"
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct LiveOptions
+{
+    std::string listen    = "stdio";   // stdio | unix:PATH | tcp:[HOST:]PORT
+    double      budget_ms = 0.0;       // per-frame latency budget (0: none)
+    std::string format    = "jsonl";   // replies: jsonl | json | binary | binary-f32
+    std::size_t report_every = 0;      // call report() every N frames of a connection
+    OverloadOptions overload;          // shed association when a connection falls behind
+    std::function<void(const metrics::Registry&)> report;   // also after each connection
+
+    /**
+     * Defaults overridden by [live] listen / budget-ms / format and the
+     * overload thresholds partial-queue / coast-queue / partial-ms /
+     * coast-ms / max-degraded.
+     */
+    static LiveOptions from(const Config& cfg);
+};
+
+/**
+ * Live mode: frames (JSON objects, one after another) are read from stdin
+ * or from a Unix / TCP socket connection as they arrive.  Each frame is
+ * stepped as soon as its closing brace is in, and its labels are written
+ * and flushed back at once - to stdout, or on the same connection - so no
+ * output waits for end of input.
+ *
+ * Each connection gets its own thread and its own copy of `prototype`.
+ * The `latency` stage times every frame from "frame received" to "labels
+ * flushed"; frames over the budget count as `missed_budget`.
+ *
+ * With overload thresholds set, each connection's OverloadPolicy picks
+ * the StepMode of every frame from the frames already received behind it
+ * (estimated from the unread input bytes) and the recent full-frame
+ * latency.  A coasted frame still gets its (empty) reply.
+ */
+class LiveServer
+{
+public:
+    LiveServer(const Tracker& prototype, const LiveOptions& opt);
+    ~LiveServer();
+
+    LiveServer(const LiveServer&)            = delete;
+    LiveServer& operator=(const LiveServer&) = delete;
+
+    /**
+     * stdio: serve stdin until EOF and return the number of frames; errors
+     * are rethrown.  Sockets: accept connections until the listening
+     * socket fails; a failing connection is logged and closed.
+     */
+    std::size_t run();
+
+    /** Finished connections plus the last report of the open ones. */
+    metrics::Registry metrics() const;
+
+private:
+    struct Session;
+
+    std::size_t serve(int in_fd, int out_fd, bool socket, Session* s);
+    void        listen_socket();
+    void        publish(Session* s, const metrics::Registry& r, bool last);
+    void        reap(bool all);
+
+    Tracker     prototype_;
+    LiveOptions opt_;
+    int         listen_fd_ = -1;
+    std::string unix_path_;                 // unlinked on destruction
+
+    mutable std::mutex        mu_;          // done_, sessions_[].snapshot
+    std::mutex                report_mu_;   // serialises opt_.report
+    metrics::Registry         done_;
+    std::list<std::unique_ptr<Session>> sessions_;
+};
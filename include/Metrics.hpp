@@ -0,0 +1,178 @@
+// Metrics.hpp - per-stage latency histograms and counters.
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Compile-time switch (CMake option TRACKER_METRICS).  When 0 the timers
+// and counters below compile to nothing and every histogram stays empty.
+#ifndef TRACKER_METRICS
+#  define TRACKER_METRICS 1
+#endif
+
+namespace metrics {
+
+constexpr bool enabled = TRACKER_METRICS != 0;
+
+/**
+ * Timed stages: the seven phases of Tracker::step, the whole step, I/O,
+ * live mode's frame-received-to-labels-flushed latency, and a batch
+ * backend's host<->device copies and kernel time.
+ */
+enum Stage : int
+{
+    Predict, Gate, Assign, Correct, Spawn, Labels, Cull, Step,
+    Parse, Write, Vis, Latency,
+    Transfer, Kernel,
+    kStages
+};
+
+enum Counter : int
+{
+    Frames,          // steps taken
+    Detections,      // detections seen
+    Matches,         // detections associated with an existing track
+    Spawned,         // new tracks
+    Culled,          // tracks dropped after max_age
+    Candidates,      // gated (track, detection) pairs
+    AssignCells,     // entries handed to the solver (N*N dense, #pairs sparse, residual N*N cascade)
+    Allocations,     // heap allocations inside step (needs TRACKER_COUNT_ALLOCS)
+    WarmSeeded,      // dense rows matched by the warm start, no augmenting path
+    FastPath,        // cascade: matches committed before the solver
+    ParallelGates,   // frames gated on the work pool
+    MissedBudget,    // live: frames whose latency exceeded the budget
+    Stitched,        // chunked: track ids carried across a chunk boundary
+    Evicted,         // unmatched tracks dropped to make room under the track limit
+    Refused,         // detections left without a track at the track limit
+    BatchedSteps,    // steps whose predict / gate / correct ran on a batch backend
+    Coasted,         // overload: frames only predicted (StepMode::Coast)
+    Partial,         // overload: frames associated on the fast path only (StepMode::Partial)
+    kCounters
+};
+
+const char* stage_name(Stage s);
+const char* counter_name(Counter c);
+
+/**
+ * Log-linear latency histogram in nanoseconds: 8 linear sub-buckets per
+ * power of two, so any quantile is within 12.5% of the true value.  Fixed
+ * size, no allocation; record() is a few integer ops.
+ */
+class Histogram
+{
+public:
+    static constexpr int sub  = 8;
+    static constexpr int size = (64 - 2) * sub;
+
+    void record(std::uint64_t ns)
+    {
+        ++bins_[index(ns)];
+        ++count_; sum_ += ns;
+        if (ns > max_) max_ = ns;
+    }
+
+    void merge(const Histogram& o);
+
+    std::uint64_t count() const { return count_; }
+    std::uint64_t sum()   const { return sum_; }
+    std::uint64_t max()   const { return max_; }
+
+    /** Approximate q-quantile (0..1) in ns; 0 when empty. */
+    double quantile(double q) const;
+
+private:
+    static int index(std::uint64_t v)
+    {
+        if (v < sub) return static_cast<int>(v);
+        const int msb = 63 - __builtin_clzll(v);
+        return (msb - 2) * sub + static_cast<int>((v >> (msb - 3)) & (sub - 1));
+    }
+    static double lower(int i);      // smallest value of bucket i
+
+    std::array<std::uint64_t, size> bins_{};
+    std::uint64_t count_ = 0, sum_ = 0, max_ = 0;
+};
+
+/**
+ * Everything one thread records.  Not synchronised: each tracker / stage
+ * thread owns one and they are merge()d for reporting.
+ */
+struct Registry
+{
+    std::array<Histogram, kStages>       stage{};
+    std::array<std::uint64_t, kCounters> counter{};
+    std::int64_t                         tracks_alive = 0;   // gauge
+
+    void add(Counter c, std::uint64_t n) { if constexpr (enabled) counter[c] += n; }
+    void merge(const Registry& o);
+};
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Stopwatch for consecutive stages: mark(s) charges the time since the
+ * previous mark (or construction) to s; total(s) charges the whole span.
+ */
+class Lap
+{
+public:
+    explicit Lap(Registry& r) : r_(r)
+    {
+        if constexpr (enabled) t0_ = last_ = Clock::now();
+    }
+
+    /** Resume a span that started at t0 (e.g. in an earlier call). */
+    Lap(Registry& r, Clock::time_point t0) : r_(r), t0_(t0), last_(t0) {}
+
+    void mark(Stage s)
+    {
+        if constexpr (enabled) {
+            const auto now = Clock::now();
+            r_.stage[s].record(ns(now - last_));
+            last_ = now;
+        }
+    }
+
+    void total(Stage s)
+    {
+        if constexpr (enabled) r_.stage[s].record(ns(Clock::now() - t0_));
+    }
+
+private:
+    static std::uint64_t ns(Clock::duration d)
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+    }
+
+    Registry&         r_;
+    Clock::time_point t0_{}, last_{};
+};
+
+/** Charges its lifetime to one stage. */
+class Scoped
+{
+public:
+    Scoped(Registry& r, Stage s) : lap_(r), s_(s) {}
+    ~Scoped() { lap_.total(s_); }
+    Scoped(const Scoped&)            = delete;
+    Scoped& operator=(const Scoped&) = delete;
+
+private:
+    Lap   lap_;
+    Stage s_;
+};
+
+/** Summary (count, sum, p50/p90/p99, max per stage), counters and gauges. */
+std::string to_json(const Registry& r);
+
+/** Prometheus text exposition format, metric names prefixed `tracker_`. */
+std::string to_prometheus(const Registry& r);
+
+/**
+ * Write r to path in "json" or "prometheus" format through a temporary
+ * file and rename, so scrapers never see a half-written file.
+ */
+void write_file(const std::string& path, const std::string& format, const Registry& r);
+
+} // namespace metrics
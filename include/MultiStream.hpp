@@ -0,0 +1,129 @@
+// MultiStream.hpp - many independent trackers scheduled on one worker pool.
+#pragma once
+#include "BatchBackend.hpp"
+#include "FrameIO.hpp"
+#include "Tracker.hpp"
+#include "Metrics.hpp"
+#include "Config.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct MultiStreamOptions
+{
+    unsigned    workers = 0;      // 0 = std::thread::hardware_concurrency()
+    std::size_t window  = 256;    // frames in flight between reader and writer
+    std::size_t batch_streams = 0;      // > 1: step up to this many streams at once per worker
+    std::string backend = "cpu";        // batch_streams: cpu | opencl (BatchBackend.hpp)
+
+    /** Defaults overridden by [pipeline] workers / window / batch-streams / backend. */
+    static MultiStreamOptions from(const Config& cfg);
+};
+
+/**
+ * One Tracker per input stream id, all in one process.  The calling thread
+ * reads frames and appends each to its stream's queue; a stream with
+ * pending frames is scheduled on a worker's deque (its home worker, by
+ * id), and idle workers steal whole streams from the back of other
+ * deques.  A stream is owned by at most one worker at a time and drains
+ * its queue in arrival order, so per-stream frame order is kept while
+ * different streams step in parallel.
+ *
+ * With batch_streams > 1 a worker takes up to that many runnable streams
+ * and steps them in lockstep, one frame each per round, through
+ * step_batch(): the filter and gating of the whole group run as one
+ * batch on the backend, association per stream.  Per-stream order and
+ * output are the same as unbatched (exactly so on the cpu backend).
+ *
+ * A writer thread emits labels in input order through sink.write_stream();
+ * at most `window` frames are in flight, so a stalled worker eventually
+ * throttles the reader instead of buffering the input.
+ */
+class MultiStreamEngine
+{
+public:
+    /** Every new stream starts from a copy of `prototype`. */
+    explicit MultiStreamEngine(const Tracker& prototype, const MultiStreamOptions& opt = {});
+
+    MultiStreamEngine(const MultiStreamEngine&)            = delete;
+    MultiStreamEngine& operator=(const MultiStreamEngine&) = delete;
+
+    /** Track all of src into sink; returns #frames.  Call once. */
+    std::size_t run(FrameSource& src, LabelSink& sink);
+
+    std::size_t streams() const { return streams_.size(); }
+
+    /** All streams' tracker metrics plus parse / write and backend latencies (after run). */
+    metrics::Registry metrics() const;
+
+private:
+    struct Job
+    {
+        Frame              frame;
+        std::vector<Label> labels;
+        bool               done = false;    // guarded by out_m_
+    };
+
+    struct Stream
+    {
+        explicit Stream(const Tracker& t, unsigned home) : tracker(t), home(home) {}
+        Tracker          tracker;
+        unsigned         home;
+        std::mutex       m;
+        std::deque<Job*> pending;
+        bool             scheduled = false;  // on a deque or being run
+    };
+
+    struct Worker
+    {
+        std::mutex          m;
+        std::deque<Stream*> runnable;
+
+        // batch_streams: this worker's backend and round scratch
+        std::unique_ptr<BatchBackend> backend;
+        metrics::Registry     metrics;
+        std::vector<Stream*>  group;
+        std::vector<Job*>     jobs;
+        std::vector<Tracker*> trackers;
+    };
+
+    void    worker(unsigned self);
+    Stream* take(unsigned self);
+    void    schedule(Stream* s);
+    void    drain(Stream* s, unsigned self);
+    void    drain_batch(Stream* first, unsigned self);
+    void    writer(LabelSink& sink);
+
+    Tracker            prototype_;
+    MultiStreamOptions opt_;
+
+    std::unordered_map<std::uint32_t, std::unique_ptr<Stream>> streams_;  // reader thread only
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread>             threads_;
+
+    // idle workers sleep here; `queued_` counts scheduled, untaken streams
+    std::mutex              idle_m_;
+    std::condition_variable idle_cv_;
+    std::atomic<int>        queued_{0};
+    bool                    stop_ = false;   // guarded by idle_m_
+
+    // in-flight window: slot seq % window; reader waits for free slots,
+    // the writer for the next seq to complete
+    std::vector<Job>        ring_;
+    std::mutex              out_m_;
+    std::condition_variable done_cv_, free_cv_;
+    std::size_t             read_seq_ = 0, write_seq_ = 0;
+    bool                    input_done_ = false;
+    std::exception_ptr      error_;
+
+    metrics::Registry       read_m_, write_m_;   // reader / writer thread only
+};
@@ -0,0 +1,58 @@
+// Overload.hpp - shed association work when a stream falls behind.
+#pragma once
+#include "Tracker.hpp"
+#include <cstddef>
+
+struct OverloadOptions
+{
+    std::size_t partial_queue = 0;   // frames waiting behind this one for Partial (0: off)
+    std::size_t coast_queue   = 0;   // ... for Coast
+    double      partial_ms    = 0;   // recent step latency for Partial (0: off)
+    double      coast_ms      = 0;   // ... for Coast
+    unsigned    max_degraded  = 4;   // then one full frame to resynchronise
+
+    bool enabled() const { return partial_queue || coast_queue || partial_ms > 0 || coast_ms > 0; }
+};
+
+/**
+ * Picks a StepMode per frame from how far behind the stream is: the
+ * frames already waiting behind it and a moving average of the recent
+ * step latencies.  Over a coast threshold the frame is only predicted,
+ * over a partial one it keeps only the unambiguous matches.  After
+ * max_degraded degraded frames in a row one frame always runs in full,
+ * so tracks are re-associated (and new objects picked up) even under
+ * sustained overload; full frames also resume by themselves as soon as
+ * the backlog and latency drop under the thresholds.
+ */
+class OverloadPolicy
+{
+public:
+    explicit OverloadPolicy(const OverloadOptions& opt = {}) : opt_(opt) {}
+
+    StepMode next(std::size_t queued)
+    {
+        auto over = [](double v, double limit) { return limit > 0 && v >= limit; };
+        StepMode m = StepMode::Full;
+        if      (over(double(queued), double(opt_.coast_queue))   || over(latency_ms_, opt_.coast_ms))
+            m = StepMode::Coast;
+        else if (over(double(queued), double(opt_.partial_queue)) || over(latency_ms_, opt_.partial_ms))
+            m = StepMode::Partial;
+
+        if (m == StepMode::Full || degraded_ >= opt_.max_degraded) { degraded_ = 0; return StepMode::Full; }
+        ++degraded_;
+        return m;
+    }
+
+    /** Latency of the frame just stepped; full frames only, so coasting cannot hide a slow tracker. */
+    void record(StepMode m, double ms)
+    {
+        if (m == StepMode::Full) latency_ms_ += (ms - latency_ms_) * smoothing;
+    }
+
+private:
+    static constexpr double smoothing = 0.25;     // weight of the newest latency
+
+    OverloadOptions opt_;
+    double          latency_ms_ = 0;
+    unsigned        degraded_   = 0;
+};
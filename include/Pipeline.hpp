@@ -0,0 +1,44 @@
+// Pipeline.hpp - three-stage parse / track / serialise runner.
+#pragma once
+#include "FrameIO.hpp"
+#include "Tracker.hpp"
+#include "Metrics.hpp"
+#include "Config.hpp"
+#include <cstddef>
+#include <functional>
+
+class VisPipeline;
+
+/** Optional per-run extras handed to the runners. */
+struct RunHooks
+{
+    VisPipeline*       vis = nullptr;   // fed from the tracker stage
+    metrics::Registry* io  = nullptr;   // receives parse / write / vis latencies
+    std::function<void(std::size_t frames)> on_frame;   // tracker stage, after each step
+};
+
+struct PipelineOptions
+{
+    std::size_t frame_queue = 64;   // parsed frames waiting for the tracker
+    std::size_t label_queue = 64;   // label frames waiting for the serialiser
+
+    /** Defaults overridden by [pipeline] frame-queue / label-queue. */
+    static PipelineOptions from(const Config& cfg);
+};
+
+/**
+ * Runs src -> tracker -> sink on three threads joined by SpscRing buffers:
+ * a parser thread fills Frame slots, the calling thread steps the tracker
+ * (and runs the hooks), a serialiser thread drains Label slots into the
+ * sink.  Frame order is preserved end to end; slots are reused, so the
+ * steady state does not allocate per frame.  Exceptions from any stage
+ * stop the others and are rethrown here.  Parse / write latencies are
+ * recorded per thread and merged into hooks.io when the run ends.
+ * Returns #frames tracked; the caller still calls sink.finish().
+ */
+std::size_t run_pipelined(FrameSource& src, Tracker& tracker, LabelSink& sink,
+                          const RunHooks& hooks = {}, const PipelineOptions& opt = {});
+
+/** Same contract on the calling thread only (the default). */
+std::size_t run_sequential(FrameSource& src, Tracker& tracker, LabelSink& sink,
+                           const RunHooks& hooks = {});
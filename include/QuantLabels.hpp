@@ -0,0 +1,104 @@
+#pragma once
+#include "BinaryFormat.hpp"
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Quantised, delta-coded label stream ("TRKQ") for downstream consumers
+ * that want the tracks at a fraction of the TRKL size.  Little-endian.
+ *
+ *   file header   16 B   magic[4] | u16 version | u16 flags | u32 block frames | u32 0
+ *                        flags: bit 1 per-frame stream id, bits 8-11 codec
+ *   per block     16 B   u32 raw bytes | u32 stored bytes | u32 frames | u32 0
+ *                 then the stored bytes: the frames below, compressed
+ *                 with the file's codec (as is if stored == raw, e.g.
+ *                 for "none" or a block that would not shrink)
+ *   per frame            v ts (delta to the block's previous frame, us)
+ *                        [v stream] | v count | count labels:
+ *     label              v (id delta to the previous label) << 1 | ref
+ *                        ref 0: u16 x, y, w, h
+ *                        ref 1: v x, y, w, h, each a delta to the box this
+ *                               track (same stream and id) had last time
+ *
+ * v is a LEB128 varint of a zigzag-coded signed value.  Coordinates are
+ * 16-bit fixed point over the normalised [0, 1] range (q = round(v 65535),
+ * clamped), so every coordinate is within 7.7e-6 of its input.  Delta
+ * state restarts with every block, which keeps blocks independently
+ * decodable; more frames per block means more deltas.
+ */
+namespace bin {
+
+constexpr std::uint16_t quant_version = 1;
+
+enum class Codec : std::uint16_t { None = 0, Zstd = 1, Lz4 = 2 };
+
+/** "none" | "zstd" | "lz4"; throws if the codec was not built in. */
+Codec       codec_from(const std::string& name);
+const char* codec_name(Codec c);
+bool        codec_available(Codec c);
+
+struct BlockHeader { std::uint32_t raw, stored, frames, reserved; };
+static_assert(sizeof(BlockHeader) == 16, "binary layout");
+
+} // namespace bin
+
+/** Writes a TRKQ stream, one block per `block_frames` frames. */
+class QuantLabelWriter : public LabelSink
+{
+public:
+    static constexpr std::uint32_t default_block_frames = 64;
+
+    explicit QuantLabelWriter(std::ostream& out, bool streams = false,
+                              bin::Codec codec = bin::Codec::None,
+                              std::uint32_t block_frames = default_block_frames);
+    ~QuantLabelWriter() override;
+    QuantLabelWriter(const QuantLabelWriter&) = delete;
+    QuantLabelWriter& operator=(const QuantLabelWriter&) = delete;
+
+    void write(double ts, const std::vector<Label>& labels) override
+    { write_stream(0, ts, labels); }
+    void write_stream(std::uint32_t stream, double ts, const std::vector<Label>& labels) override;
+    void finish() override;
+
+private:
+    void flush_block();
+
+    std::ostream&     out_;
+    bool              streams_;
+    bin::Codec        codec_;
+    std::uint32_t     block_frames_, frames_ = 0;
+    std::int64_t      prev_ts_ = 0;
+    std::unordered_map<std::uint64_t, std::array<std::uint16_t,4>> last_;   // (stream, id) -> box
+    std::vector<char> raw_, packed_;
+    void*             cctx_ = nullptr;     // zstd compression context
+};
+
+/** Reads a TRKQ file, one block at a time. */
+class QuantLabelReader
+{
+public:
+    explicit QuantLabelReader(const std::string& path);
+
+    bool next(double& ts, std::vector<Label>& labels, std::uint32_t* stream = nullptr);
+
+    bool streams() const { return streams_; }
+
+private:
+    bool load_block();
+
+    MappedFile  file_;
+    const char* p_;
+    const char* end_;
+    bool        streams_;
+    bin::Codec  codec_;
+    std::vector<char> raw_;
+    const char* q_ = nullptr;              // next frame in raw_
+    const char* qend_ = nullptr;
+    std::uint32_t left_ = 0;               // frames left in the block
+    std::int64_t  prev_ts_ = 0;
+    std::unordered_map<std::uint64_t, std::array<std::uint16_t,4>> last_;
+};
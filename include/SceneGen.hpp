@@ -0,0 +1,70 @@
+// SceneGen.hpp - in-process synthetic scenes (motion model of generate_input.py).
+#pragma once
+#include "FrameIO.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/** Parameters of tests/generate_input.py, same names and defaults as its CLI. */
+struct SceneParams
+{
+    int    frames      = 30;
+    double dt_min      = 0.030, dt_max = 0.040;
+    int    min_objects = 1,     max_objects = 5;
+    int    min_life    = 5,     max_life    = 20;
+    double min_size    = 0.10,  max_size    = 0.20;
+    double bias_x      = 0.0,   bias_y      = 0.0;
+    double wind_sigma  = 0.02,  wind_max    = 0.10;
+    double rot_sigma   = 0.0,   scale_sigma = 0.0;
+    double step_max    = 0.0,   sway_sigma  = 0.01;
+    double noise_pos   = 0.002, noise_size  = 0.001;
+    double drop_prob   = 0.05;
+    int    drop_max    = 3;
+    std::uint64_t seed = 0;
+};
+
+/**
+ * Frame-at-a-time version of the Python generator: anchored objects with
+ * random lifetimes, a bounded shared wind walk plus per-object sway and
+ * walk, global rotation / zoom about the image centre, Gaussian
+ * measurement noise and drop-out runs.  Objects are spawned lazily, so
+ * memory is O(live objects) however many frames are asked for.
+ *
+ * Deterministic for a given seed, but not the same random stream as the
+ * Python script.  truth() holds the ground-truth id of every detection of
+ * the last frame (the expected.json track ids).
+ */
+class SceneGenerator : public FrameSource
+{
+public:
+    explicit SceneGenerator(const SceneParams& p);
+
+    bool next(Frame& fr) override;
+
+    const std::vector<int>& truth() const { return truth_; }
+
+private:
+    struct Object
+    {
+        int    id, end;
+        double ax, ay, x, y, w, h;
+        int    drop_remaining;
+        bool   seen_once;
+    };
+
+    double gauss(double sigma) { return sigma > 0.0 ? sigma * normal_(rng_) : 0.0; }
+    double uniform(double lo, double hi)
+    { return lo + (hi - lo) * std::uniform_real_distribution<double>(0.0, 1.0)(rng_); }
+    int    randint(int lo, int hi)             // inclusive, like random.randint
+    { return std::uniform_int_distribution<int>(lo, hi)(rng_); }
+
+    SceneParams         p_;
+    std::mt19937_64     rng_;
+    std::normal_distribution<double> normal_{0.0, 1.0};
+    std::vector<Object> live_;
+    std::vector<int>    truth_;
+    int                 frame_   = 0;
+    int                 next_id_ = 0;
+    double              ts_;
+    double              wind_x_ = 0.0, wind_y_ = 0.0;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ * Uniform cell list over points in (roughly) the unit square.
+ *
+ * Cells are at least `radius` wide, so every point within `radius` of a
+ * query lies in the query's cell or one of its 8 neighbours.  Points
+ * outside [0,1] are clamped into the border cells, which keeps that
+ * guarantee.  build() is a counting sort into CSR buckets and reuses its
+ * buffers, so rebuilding every frame is cheap.
+ */
+class SpatialGrid
+{
+public:
+    void build(const std::vector<double>& x, const std::vector<double>& y,
+               double radius);
+
+    /** Call f(i) for every point i in the 3x3 cells around (x, y). */
+    template<class F>
+    void query(double x, double y, F&& f) const
+    {
+        if (items_.empty()) return;
+        const int cx = cell(x), cy = cell(y);
+        for (int gy=std::max(cy-1,0); gy<=std::min(cy+1,G_-1); ++gy)
+            for (int gx=std::max(cx-1,0); gx<=std::min(cx+1,G_-1); ++gx) {
+                const int c = gy*G_ + gx;
+                for (int k=start_[c]; k<start_[c+1]; ++k) f(items_[k]);
+            }
+    }
+
+private:
+    int cell(double v) const
+    {
+        const double c = std::floor(v * G_);
+        return c < 0 ? 0 : (c >= G_ ? G_-1 : static_cast<int>(c));
+    }
+
+    int              G_ = 1;          // cells per side
+    std::vector<int> start_;          // CSR offsets, G_*G_ + 1
+    std::vector<int> items_;          // point indices grouped by cell
+    std::vector<int> cell_of_;        // cell of each point
+};
@@ -0,0 +1,162 @@
+#pragma once
+#include "Detection.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <vector>
+
+/** Value snapshot of one track, built on demand from the store. */
+struct Track
+{
+    int             id          = -1;
+    std::array<double,4> rect{}; // [x y w h] from the *KF state*
+    double          last_ts     = 0.0;
+    int             age         = 0;
+    int             time_since_update = 0;
+};
+
+/**
+ * Structure-of-arrays track store over numeric type T (float or double).
+ *
+ * Every per-track quantity lives in its own contiguous column so that
+ * predict / correct run as one vectorised pass over all tracks (AVX2 or
+ * NEON when the compiler targets them, scalar otherwise).  The filter
+ * state is the block-diagonal form from kalman.hpp: for each of the axes
+ * x, y, w, h a position, a velocity and a 2x2 covariance.  Timestamps
+ * stay double (epoch seconds do not fit a float); dt is taken in double
+ * and then narrowed.  In float, 8 tracks fit an AVX2 register instead of 4.
+ *
+ * Columns stay packed (cull swaps the last track into the hole), so a
+ * track's index changes over its life.  Each track also owns a slot of a
+ * slot table; handle(i) names it by slot and generation, and find() maps
+ * a handle back to the current index until the track is removed.  Freed
+ * slots go on a free list and are reused with the next generation.
+ * After reserve(n), up to n tracks are pushed without allocating.
+ */
+template<class T>
+class BasicTrackStore
+{
+public:
+    using value_type = T;
+    struct Axis { std::vector<T> p, v, P00, P01, P11; };
+
+    // ─── columns ────────────────────────────────────────────────────
+    std::vector<int>    id;
+    std::vector<double> last_ts;
+    std::vector<int>    age;
+    std::vector<int>    time_since_update;
+    std::vector<double> dual;               // dense-solver row potential, NaN: none yet
+    std::array<Axis,4>  ax;                 // x, y, w, h
+
+    /** Stable name of a track: slot + generation, valid until it is removed. */
+    struct Handle { std::uint32_t slot, gen; };
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    std::size_t size()  const { return id.size(); }
+    bool        empty() const { return id.empty(); }
+
+    std::array<T,4> rect(std::size_t i) const
+    { return {ax[0].p[i], ax[1].p[i], ax[2].p[i], ax[3].p[i]}; }
+
+    Track operator[](std::size_t i) const
+    {
+        const auto r = rect(i);
+        return {id[i], {r[0], r[1], r[2], r[3]}, last_ts[i], age[i], time_since_update[i]};
+    }
+
+    Handle handle(std::size_t i) const { return {slot_[i], gen_[slot_[i]]}; }
+
+    /** Current index of the track h names; npos once it is gone. */
+    std::size_t find(Handle h) const
+    { return h.slot < gen_.size() && gen_[h.slot] == h.gen ? index_[h.slot] : npos; }
+
+    /** Room for n tracks in every column, the slot table and the scratch. */
+    void reserve(std::size_t n);
+    std::size_t capacity() const { return slot_.capacity(); }
+
+    /** Append a fresh track initialised from a detection. */
+    void push(int track_id, double ts, const BasicDetection<T>& d);
+
+    /**
+     * Predict every track to ts; bumps age, and time_since_update unless
+     * count_miss is false (a frame that did not try to match them).  dt
+     * and Q are formed once for the tracks last updated at the latest
+     * push / correct time (most of them), per track for the rest.
+     */
+    void predict(double ts, bool count_miss = true);
+
+    /** Correct every track with tr2det[i] != -1 against dets[tr2det[i]]. */
+    void correct(double ts, const int* tr2det, const BasicDetection<T>* dets);
+
+    /**
+     * The bookkeeping half of predict() and correct(), for a backend that
+     * runs the filter itself (BatchBackend): age_all() bumps age and
+     * (with count_miss) time_since_update; mark_updated() stamps the
+     * tracks with tr2det[i] != -1 as updated at ts.
+     */
+    void age_all(bool count_miss = true);
+    void mark_updated(double ts, const int* tr2det);
+
+    /** Swap-and-pop every track unmatched for more than max_age frames. */
+    void cull(int max_age);
+
+    /** Swap-and-pop track i: the last track moves into its index. */
+    void remove(std::size_t i);
+
+    void clear();
+
+    /**
+     * All columns (and the predict() hint) as raw native arrays, in the
+     * layout BasicTracker::save() documents.  restore() replaces the
+     * contents with n tracks written that way; throws std::runtime_error
+     * on a short read.  Handles are not saved: earlier ones go stale and
+     * the restored tracks get fresh slots.
+     */
+    void save(std::ostream& out) const;
+    void restore(std::istream& in, std::size_t n);
+
+    // ─── lightweight iteration (yields Track snapshots) ─────────────
+    class const_iterator
+    {
+    public:
+        const_iterator(const BasicTrackStore* s, std::size_t i) : s_(s), i_(i) {}
+        Track operator*() const { return (*s_)[i_]; }
+        const_iterator& operator++() { ++i_; return *this; }
+        bool operator!=(const const_iterator& o) const { return i_ != o.i_; }
+        bool operator==(const const_iterator& o) const { return i_ == o.i_; }
+    private:
+        const BasicTrackStore* s_;
+        std::size_t       i_;
+    };
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end()   const { return {this, size()}; }
+
+private:
+    void move_slot(std::size_t from, std::size_t to);
+    void pop_back();
+    void take_slot(std::size_t i);          // for track i, appended after slot_.size()-1
+    void release_slots();                   // every live slot, e.g. before clear
+
+    // slot table: slot of each track (column), index and generation of
+    // each slot, and the free slots (LIFO)
+    std::vector<std::uint32_t>   slot_;
+    std::vector<std::size_t>     index_;
+    std::vector<std::uint32_t>   gen_;
+    std::vector<std::uint32_t>   free_;
+
+    // correct() scratch, reused across frames
+    std::array<std::vector<T>,4> z_;
+    std::vector<T>               mask_;
+    // last push / correct time: the last_ts most tracks share, so predict()
+    // forms dt and Q once for all of them (NaN: none yet)
+    double                       latest_ts_ = std::numeric_limits<double>::quiet_NaN();
+};
+
+extern template class BasicTrackStore<float>;
+extern template class BasicTrackStore<double>;
+
+using TrackStore  = BasicTrackStore<tracker_real>;
+using TrackStoreF = BasicTrackStore<float>;
+using TrackStoreD = BasicTrackStore<double>;
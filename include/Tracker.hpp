@@ -1,55 +1,258 @@
 #pragma once
-#include <opencv2/opencv.hpp>
+#include "Detection.hpp"
+#include "TrackStore.hpp"
+#include "sparse_assign.hpp"
+#include "hungarian.hpp"
+#include "SpatialGrid.hpp"
+#include "gate_kernels.hpp"
+#include "Metrics.hpp"
+#include "WorkPool.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <string>
 #include <vector>
 
-struct Detection
+struct Label            // <-- new: what we emit each frame
 {
-    double x, y, w, h;   // normalised
+    int        track_id; // stable ID
+    Detection  det;      // the raw detection that was matched
 };
 
-struct Track
+/** Association back-end used in step 3. */
+enum class Assigner
 {
-    int             id          = -1;
-    cv::KalmanFilter kf;
-    cv::Mat         rect;       // [x y w h] from the *KF state*
-    double          last_ts     = 0.0;
-    int             age         = 0;
-    int             time_since_update = 0;
+    Dense,      // N x N padded matrix through hungarian()
+    Sparse,     // gated edges, per-component solve (sparse_assign.hpp)
+    Cascade     // greedy unique / high-IoU pairs, hungarian() on the rest
 };
 
-struct Label            // <-- new: what we emit each frame
+/** "dense" | "sparse" | "cascade"; throws std::invalid_argument otherwise. */
+Assigner assigner_from(const std::string& name);
+
+/**
+ * How much of a step runs; the lighter modes are for frames an overload
+ * policy (Overload.hpp) sheds work on.  A degraded frame spawns no tracks,
+ * and tracks it leaves unmatched do not count it as a miss toward
+ * max_age, so ids survive a burst of them.
+ */
+enum class StepMode
 {
-    int        track_id; // stable ID
-    Detection  det;      // the raw detection that was matched
+    Full,       // every stage
+    Partial,    // no solver: the cascade fast path, then greedy for tracks matched last time
+    Coast       // no association, no labels; tracks coast on their last update
 };
 
-class Tracker
+/**
+ * Multi-object tracker over numeric type T: the filter state, gating
+ * metrics and assignment costs are T, while detections come in and labels
+ * go out in double (float trackers narrow each frame's detections once).
+ * BasicTracker<float> and BasicTracker<double> are both built; Tracker
+ * names the one picked by TRACKER_FLOAT.
+ */
+template<class T>
+class BasicTracker
 {
 public:
-    Tracker(double max_dist = 0.15,
-            int    max_age  = 5,
-            double alpha    = 0.7);
+    using value_type = T;
 
-    /** Process one frame, return the labels that should be written. */
-    std::vector<Label> step(double ts,
-                            const std::vector<Detection>& dets);
+    BasicTracker(double   max_dist = 0.15,
+            int      max_age  = 5,
+            double   alpha    = 0.7,
+            Assigner assigner = Assigner::Dense,
+            bool     warm_start = true,
+            double   fast_iou = 0.7);
+
+    /**
+     * Process one frame, return the labels that should be written.  The
+     * result is a view of the tracker's own buffer, valid until the next
+     * step(); copy it to keep it.  Per-frame scratch is kept in members at
+     * its high-water mark, so after warm-up step() does not allocate.
+     */
+    const std::vector<Label>& step(double ts,
+                                   const std::vector<Detection>& dets)
+    { return step(ts, dets.data(), dets.size()); }
+
+    /** Same, over a caller-owned contiguous detection buffer (no copy). */
+    const std::vector<Label>& step(double ts, const Detection* dets, std::size_t n)
+    { step_into(ts, dets, n, nullptr); return labels_; }
+
+    /**
+     * Same, writing the labels straight into a caller-owned buffer of at
+     * least n entries (one label per detection, in detection order).
+     * Returns the number written.
+     */
+    std::size_t step(double ts, const Detection* dets, std::size_t n, Label* out)
+    { return step_into(ts, dets, n, out); }
+
+    /** Same, running only as much as `mode` says. */
+    const std::vector<Label>& step(double ts, const Detection* dets, std::size_t n, StepMode mode)
+    { step_into(ts, dets, n, nullptr, mode); return labels_; }
 
     /** Access to internal tracks (for visualisation only). */
-    const std::vector<Track>& tracks() const { return tracks_; }
+    const BasicTrackStore<T>& tracks() const { return tracks_; }
+
+    /** Stage latencies and counters of this tracker's steps. */
+    const metrics::Registry& metrics() const { return metrics_; }
+
+    // ─── staged step, for batch drivers (BatchBackend.hpp) ───────────
+    using Edge = BasicSparseEdge<T>;
+
+    /**
+     * step() is begin(), predict(), gate(), associate(), correct() and
+     * finish(), called in that order; running them one by one gives the
+     * same labels.  A driver that batches many trackers may instead do
+     * the predict / gate / correct work for all of them at once through
+     * view(), as long as it leaves the same state behind.  The detections
+     * must stay valid until finish().  begin() takes the frame's StepMode;
+     * gate() and correct() do nothing on a Coast frame.
+     */
+    void begin(double ts, const Detection* dets, std::size_t n, StepMode mode = StepMode::Full);
+    void predict();
+    void gate();
+    void associate();
+    void correct();
+    std::size_t finish(Label* out);
+
+    /** What predict / gate / correct work on, between begin() and finish(). */
+    struct View
+    {
+        BasicTrackStore<T>&      tracks;
+        double                   ts;
+        const BasicDetection<T>* dets;     // this frame, in T
+        std::size_t              n;
+        gate::Gate<T>            gate;     // pairs kept and their cost
+        std::vector<Edge>&       edges;    // gate(): (track, det, cost), detection-major
+        std::vector<T>&          ious;     // IoU of each edge
+        const std::vector<int>&  tr2det;   // after associate(): det of each track, or -1
+    };
+    View view();
+
+    /** Track x detection pairs from which gating is split across threads. */
+    static constexpr std::size_t parallel_gate_pairs = std::size_t(1) << 16;
+
+    /**
+     * Gate on `threads` threads (0: one per core, 1: serial, the default)
+     * for frames with at least min_pairs track x detection pairs; smaller
+     * frames stay on the calling thread.  Detections are split into
+     * contiguous parts whose candidates are joined in order, so the result
+     * is exactly the serial one.  Not part of the snapshot.
+     */
+    void set_parallel_gate(unsigned threads, std::size_t min_pairs = parallel_gate_pairs)
+    { pool_ = WorkPool(threads); gate_min_pairs_ = min_pairs; }
+
+    /**
+     * Keep at most max_tracks tracks alive (0: unbounded, the default) and
+     * reserve the store for them, so spawning never allocates.  When a
+     * frame would spawn past the cap, the stalest unmatched tracks are
+     * evicted first (most frames since their last match, then youngest);
+     * detections still without room get no track and no label.
+     */
+    void set_track_limit(std::size_t max_tracks);
+    std::size_t track_limit() const { return max_tracks_; }
+
+    /** Timestamp of the last step() (NaN before the first). */
+    double time() const { return time_; }
+
+    /**
+     * Compact binary snapshot ("TRKS") of everything that decides the next
+     * step: the parameters, the next track id, the time of the last step
+     * and every track's filter state and solver dual.  Little-endian:
+     *
+     *   header   16 B  magic[4] | u16 version | u16 flags (1: float) | u32 tracks
+ *                  | u32 track limit (0: none)
+     *   params   48 B  f64 max_dist, alpha, fast_iou, time | i32 max_age, next_id
+     *                  | u32 assigner, warm_start
+     *   store          f64 predict hint | i32 id[], age[], time_since_update[]
+     *                  | f64 last_ts[], dual[] | T p[], v[], P00[], P01[], P11[] for x, y, w, h
+     *
+     * Values are stored in T, so restore() into a tracker of the same
+     * precision continues bit for bit as if the run had never stopped.
+     * Metrics and scratch buffers are not part of it.
+     */
+    void save(std::ostream& out) const;
+
+    /**
+     * Replace this tracker's state (parameters included) with a snapshot.
+     * Throws std::runtime_error on a foreign, truncated or other-precision
+     * snapshot and then leaves the tracker unchanged.
+     */
+    void restore(std::istream& in);
+
+    // ─── gating metrics (implemented in Tracker.cpp) ─────────────────
+    static T centre_dist(const BasicDetection<T>& d, const std::array<T,4>& r);
+    static T iou(const std::array<T,4>& r, const BasicDetection<T>& d);
 
 private:
+    using Det = BasicDetection<T>;
+
+    std::size_t step_into(double ts, const Detection* dets, std::size_t n, Label* out,
+                          StepMode mode = StepMode::Full);
+
     // ─── helpers (implemented in Tracker.cpp) ────────────────────────
-    static double centre_dist(const Detection& d, const Track& t);
-    static double iou(const Track& t, const Detection& d);
-    static cv::Mat det2meas(const Detection& d);
-    static void    set_F(cv::KalmanFilter& kf, double dt);
-    static void    set_Q(cv::KalmanFilter& kf, double dt, double s = 1e-2);
-    static cv::KalmanFilter create_kf(const Detection& d);
+
+    void gate_pair(int ti, int di, const Det& d, std::vector<Edge>& edges, std::vector<T>& ious) const;
+    void gate_all (const Det* dets, int lo, int hi, gate::Candidates<T>& cand,
+                   std::vector<Edge>& edges, std::vector<T>& ious) const;
+    void gate_grid(const Det* dets, int nD, bool parallel);
+    void gate_parallel(const Det* dets, int nD, bool grid);
+    void solve_dense(int N, int nr, const int* track_of_row, T big);
+    std::size_t assign_dense  (int nT, int nD);   // return solver cells
+    std::size_t assign_sparse (int nT, int nD);
+    std::size_t assign_cascade(int nT, int nD);
+    int         assign_fast(int nT, int nD);          // cascade a + b; return matches
+    void        assign_partial(int nT, int nD);
+    std::size_t make_room(int nT, std::size_t spawns);   // return tracks evicted
 
     // ─── data ───────────────────────────────────────────────────────
-    double max_dist_, alpha_;
+    T      max_dist_, alpha_;
     int    max_age_;
     int    next_id_;
-    std::vector<Track>  tracks_;
+    double time_ = std::numeric_limits<double>::quiet_NaN();   // last step()
+    // the frame between begin() and finish()
+    const Detection*    in_ = nullptr;
+    const Det*          frame_ = nullptr;
+    std::size_t         n_ = 0, cells_ = 0;
+    int                 matched_ = 0;
+    StepMode            mode_ = StepMode::Full;
+    std::uint64_t       step_allocs_ = 0;
+    metrics::Clock::time_point step_t0_{};
+    Assigner assigner_;
+    bool   warm_start_;               // dense: seed from last frame's duals
+    T      fast_iou_;                 // cascade: IoU for a greedy mutual match
+    BasicTrackStore<T>  tracks_;
+    std::size_t         max_tracks_ = 0;              // 0: unbounded
+    std::vector<int>    victims_;     // make_room() scratch
+    std::vector<Det>    dets_;        // float: this frame's detections, narrowed
     std::vector<Label>  labels_;      // reused every frame
+    std::vector<Edge>   edges_;       // gated (track, det, cost) pairs
+    std::vector<T>      edge_iou_;    // IoU of each edge
+    WorkPool            pool_;        // parallel gating helpers
+    std::size_t         gate_min_pairs_ = parallel_gate_pairs;
+    std::vector<std::vector<Edge>> part_edges_;   // parallel gating, per part
+    std::vector<std::vector<T>>    part_iou_;
+    gate::Candidates<T>               cand_;        // dense: one detection's candidates
+    std::vector<gate::Candidates<T>>  part_cand_;
+    std::vector<int>    tr2det_, det2tr_;
+    SparseAssignWs      sparse_ws_;
+    std::vector<T>      cost_;        // dense: row-major N x N
+    std::vector<int>    rowsol_;
+    std::vector<double> dual_;        // dense: row potentials in/out
+    std::vector<char>   known_;
+    std::vector<int>    best_t_, best_d_, deg_t_, deg_d_;  // cascade scratch
+    std::vector<int>    res_rows_, res_cols_;
+    std::vector<int>    order_;       // partial: edges by cost
+    HungarianWs         hungarian_ws_;
+    SpatialGrid         grid_;        // predicted track centres, per frame
+    std::vector<double> cx_, cy_;
+    metrics::Registry   metrics_;
 };
+
+extern template class BasicTracker<float>;
+extern template class BasicTracker<double>;
+
+using Tracker  = BasicTracker<tracker_real>;
+using TrackerF = BasicTracker<float>;
+using TrackerD = BasicTracker<double>;
@@ -0,0 +1,68 @@
+// VisPipeline.hpp - bounded, multi-threaded track visualisation.
+#pragma once
+#include "TrackStore.hpp"
+#include "Config.hpp"
+#include <opencv2/opencv.hpp>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct VisOptions
+{
+    std::string mode    = "png";  // off | png | video
+    std::string dir     = "vis";
+    int         every   = 1;      // render every Nth frame
+    int         threads = 2;      // encoder threads
+    int         queue   = 8;      // max snapshots waiting (back-pressure)
+    int         width   = 800, height = 600;
+    double      fps     = 30.0;   // video mode
+
+    /** Defaults overridden by [tracker] vis-dir / vis / vis-every / vis-threads / vis-queue. */
+    static VisOptions from(const Config& cfg);
+};
+
+/**
+ * Visualisation off the tracking thread.  submit() copies the boxes it
+ * needs out of the TrackStore and hands them to a pool of encoder threads
+ * through a bounded queue; when the queue is full submit() blocks, so a
+ * slow disk throttles tracking instead of growing memory.  In video mode
+ * frames are rendered in parallel and written in order to a single file.
+ */
+class VisPipeline
+{
+public:
+    explicit VisPipeline(const VisOptions& opt);
+    ~VisPipeline();
+
+    /** Tracker thread: snapshot & enqueue frame idx (subsampled). */
+    void submit(int idx, const TrackStore& tracks);
+
+    /** Drain the queue and stop the workers. */
+    void finish();
+
+private:
+    struct Box { int id; double x, y, w, h; };
+    struct Job { int idx; std::vector<Box> boxes; };
+
+    void worker();
+    void render(const Job& job, cv::Mat& img) const;
+    void write_video(int idx, cv::Mat&& img);
+
+    VisOptions               opt_;
+    std::mutex               m_;
+    std::condition_variable  not_empty_, not_full_;
+    std::deque<Job>          jobs_;
+    std::vector<std::vector<Box>> spare_;   // recycled snapshot buffers
+    bool                     stop_ = false;
+    std::vector<std::thread> workers_;
+
+    // video mode: reorder rendered frames before the single writer
+    std::mutex                          vm_;
+    cv::VideoWriter                     video_;
+    std::map<int, cv::Mat>              ready_;
+    int                                 next_write_ = 0;
+};
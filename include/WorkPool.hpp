@@ -0,0 +1,61 @@
+// WorkPool.hpp - a few persistent threads for fork-join loops inside step().
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * run(parts, f) calls f(part) for every part in [0, parts) on the
+ * calling thread plus threads()-1 helpers, and returns once all parts are
+ * done.  Parts are handed out one at a time, so uneven parts balance.
+ * The helpers are started on the first run() that needs them and sleep
+ * between runs; run() itself neither allocates nor copies f.
+ *
+ * Copies get their own (not yet started) threads, so a copied Tracker
+ * never shares its pool.  One run() at a time per pool.
+ */
+class WorkPool
+{
+public:
+    /** 0: one thread per core; 1: run() stays on the caller. */
+    explicit WorkPool(unsigned threads = 1);
+    WorkPool(const WorkPool& o) : WorkPool(o.threads_) {}
+    WorkPool& operator=(const WorkPool& o);
+    ~WorkPool();
+
+    unsigned threads() const { return threads_; }
+
+    /** The first exception thrown by f is rethrown here, after all parts ran. */
+    template<class F>
+    void run(std::size_t parts, F& f)
+    {
+        run_impl(parts, [](void* ctx, std::size_t i) { (*static_cast<F*>(ctx))(i); }, &f);
+    }
+
+private:
+    using Fn = void (*)(void*, std::size_t);
+
+    void run_impl(std::size_t parts, Fn fn, void* ctx);
+    void drain();
+    void worker();
+    void stop();
+
+    unsigned                 threads_;
+    std::vector<std::thread> helpers_;
+
+    std::mutex               m_;
+    std::condition_variable  work_cv_, done_cv_;
+    std::uint64_t            gen_  = 0;     // bumped per run; helpers take each one once
+    unsigned                 done_ = 0;     // helpers finished with gen_
+    bool                     stop_ = false;
+    Fn                       fn_   = nullptr;
+    void*                    ctx_  = nullptr;
+    std::size_t              parts_ = 0;
+    std::atomic<std::size_t> next_{0};
+    std::exception_ptr       err_;
+};
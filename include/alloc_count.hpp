@@ -0,0 +1,20 @@
+// alloc_count.hpp - optional global allocation counter (debug hook).
+#pragma once
+#include <cstdint>
+
+// With TRACKER_COUNT_ALLOCS (CMake option of the same name) the global
+// operator new is replaced by a counting one (src/alloc_count.cpp), so
+// tests and tools can check that Tracker::step stops allocating once its
+// buffers have reached their high-water mark.
+namespace alloc {
+
+#ifdef TRACKER_COUNT_ALLOCS
+constexpr bool enabled = true;
+/** Heap allocations made so far by the calling thread. */
+std::uint64_t thread_count();
+#else
+constexpr bool enabled = false;
+inline std::uint64_t thread_count() { return 0; }
+#endif
+
+} // namespace alloc
@@ -0,0 +1,89 @@
+// gate_kernels.hpp - IoU / centre distance of one detection against a block of boxes.
+#pragma once
+#include "Detection.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// The scalar pair metrics are what BasicTracker::centre_dist / iou return.
+// The batched kernel screens whole registers of boxes at a time (AVX2 or
+// NEON when the compiler targets them, scalar otherwise) against slightly
+// widened limits, and scores the pairs that survive with the scalar
+// functions, so it gates and scores exactly like a pair-by-pair loop.
+
+namespace gate {
+
+/** Distance between the centres of d and the box [rx ry rw rh]. */
+template<class T>
+inline T centre_dist(const BasicDetection<T>& d, T rx, T ry, T rw, T rh)
+{
+    const T cx_d = d.x + d.w * T(0.5),
+            cy_d = d.y + d.h * T(0.5);
+
+    const T cx_t = rx + rw * T(0.5),
+            cy_t = ry + rh * T(0.5);
+
+    return std::hypot(cx_d - cx_t, cy_d - cy_t);
+}
+
+/** Intersection over union of the box [ax ay aw ah] and d. */
+template<class T>
+inline T iou(T ax, T ay, T aw, T ah, const BasicDetection<T>& d)
+{
+    const T bx=d.x, by=d.y, bw=d.w, bh=d.h;
+
+    const T x1 = std::max(ax,bx),
+            y1 = std::max(ay,by),
+            x2 = std::min(ax+aw, bx+bw),
+            y2 = std::min(ay+ah, by+bh);
+
+    const T inter = std::max(T(0),x2-x1) * std::max(T(0),y2-y1);
+    const T uni   = aw*ah + bw*bh - inter;
+
+    return (uni>T(0) ? inter/uni : T(0));
+}
+
+/** Contiguous structure-of-arrays block of n boxes (e.g. a TrackStore's predictions). */
+template<class T>
+struct Boxes
+{
+    const T *x, *y, *w, *h;
+    std::size_t n;
+};
+
+/** Keep pairs with centre distance <= max_dist and IoU >= min_iou;
+ *  cost = alpha (1 - IoU) + (1 - alpha) distance. */
+template<class T>
+struct Gate
+{
+    T max_dist, min_iou, alpha;
+};
+
+/** Pairs that passed the gate, in box order: box index, cost, IoU. */
+template<class T>
+struct Candidates
+{
+    std::vector<int> index;
+    std::vector<T>   cost, iou;
+
+    std::size_t size() const { return index.size(); }
+    void clear() { index.clear(); cost.clear(); iou.clear(); }
+};
+
+/**
+ * Append every box of b that passes g against d to out; returns how many
+ * were appended.  Result for result the same as calling centre_dist()
+ * and iou() on each box in turn.  Buffers of out are reused, so a warm
+ * out does not allocate.
+ */
+template<class T>
+std::size_t candidates(const BasicDetection<T>& d, const Boxes<T>& b, const Gate<T>& g,
+                       Candidates<T>& out);
+
+extern template std::size_t candidates<float> (const BasicDetection<float>&,  const Boxes<float>&,
+                                               const Gate<float>&,  Candidates<float>&);
+extern template std::size_t candidates<double>(const BasicDetection<double>&, const Boxes<double>&,
+                                               const Gate<double>&, Candidates<double>&);
+
+} // namespace gate
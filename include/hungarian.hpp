@@ -3,44 +3,140 @@
 #include <vector>
 #include <limits>
 #include <algorithm>
+#include <cstddef>
+
+/** Scratch for hungarian(); reuse one per caller to stop allocating. */
+struct HungarianWs
+{
+    std::vector<double> u, v, minv;
+    std::vector<int>    p, way, rows;
+    std::vector<char>   used;
+};
+
+namespace hungarian_detail {
+
+/** Add row i (1-based) to the matching by one shortest augmenting path. */
+template<class Cost>        // cost(i, j), 0-based
+inline void augment(int n, int i, Cost& cost, HungarianWs& w)
+{
+    const double INF = std::numeric_limits<double>::infinity();
+    auto& u = w.u; auto& v = w.v; auto& p = w.p; auto& way = w.way;
+    auto& minv = w.minv;  auto& used = w.used;
+
+    p[0] = i;
+    int j0 = 0;
+    minv.assign(n+1, INF);
+    used.assign(n+1, false);
+    do{
+        used[j0] = true;
+        int i0 = p[j0], j1 = 0;
+        double delta = INF;
+        for(int j=1;j<=n;++j) if(!used[j]){
+            double cur = cost(i0-1, j-1) - u[i0] - v[j];
+            if(cur < minv[j]) { minv[j] = cur; way[j] = j0; }
+            if(minv[j] < delta) { delta = minv[j]; j1 = j; }
+        }
+        for(int j=0;j<=n;++j){
+            if(used[j]) { u[p[j]] += delta; v[j] -= delta; }
+            else { minv[j] -= delta; }
+        }
+        j0 = j1;
+    } while(p[j0] != 0);
+    do{
+        int j1 = way[j0];
+        p[j0] = p[j1];
+        j0 = j1;
+    } while(j0);
+}
+
+template<class Cost>
+inline void solve(int n, Cost cost, std::vector<int>& rowsol, double& total_cost,
+                  HungarianWs& w)
+{
+    w.u.assign(n+1, 0.0); w.v.assign(n+1, 0.0);
+    w.p.assign(n+1, 0);   w.way.assign(n+1, 0);
+    for(int i=1;i<=n;++i) augment(n, i, cost, w);
+
+    rowsol.assign(n, -1);
+    for(int j=1;j<=n;++j) if(w.p[j]) rowsol[w.p[j]-1] = j-1;
+    total_cost = -w.v[0];
+}
+
+} // namespace hungarian_detail
 
 inline int hungarian(const std::vector<std::vector<double>>& cost,
                      std::vector<int>& rowsol,
                      double& total_cost)
 {
-    int n = cost.size();
-    rowsol.assign(n, -1);
-    std::vector<double> u(n+1), v(n+1);
-    std::vector<int> p(n+1), way(n+1);
-
-    for(int i=1;i<=n;++i){
-        p[0] = i;
-        int j0 = 0;
-        std::vector<double> minv(n+1, std::numeric_limits<double>::infinity());
-        std::vector<char> used(n+1, false);
-        do{
-            used[j0] = true;
-            int i0 = p[j0], j1 = 0;
-            double delta = std::numeric_limits<double>::infinity();
-            for(int j=1;j<=n;++j) if(!used[j]){
-                double cur = cost[i0-1][j-1] - u[i0] - v[j];
-                if(cur < minv[j]) { minv[j] = cur; way[j] = j0; }
-                if(minv[j] < delta) { delta = minv[j]; j1 = j; }
-            }
-            for(int j=0;j<=n;++j){
-                if(used[j]) { u[p[j]] += delta; v[j] -= delta; }
-                else { minv[j] -= delta; }
-            }
-            j0 = j1;
-        } while(p[j0] != 0);
-        do{
-            int j1 = way[j0];
-            p[j0] = p[j1];
-            j0 = j1;
-        } while(j0);
+    HungarianWs w;
+    hungarian_detail::solve(static_cast<int>(cost.size()),
+                            [&](int i, int j){ return cost[i][j]; },
+                            rowsol, total_cost, w);
+    return 0;
+}
+
+/**
+ * Same solver over a row-major n x n matrix of T (float or double) with
+ * caller-owned scratch.  Potentials are always accumulated in double.
+ */
+template<class T>
+inline int hungarian(const T* cost, int n,
+                     std::vector<int>& rowsol,
+                     double& total_cost,
+                     HungarianWs& w)
+{
+    hungarian_detail::solve(n, [&](int i, int j){ return double(cost[std::size_t(i)*n + j]); },
+                            rowsol, total_cost, w);
+    return 0;
+}
+
+/**
+ * Warm-started solve over a row-major n x n matrix.  Rows with known[i]
+ * start from row potential u[i] (typically the previous frame's); the
+ * column potentials are rebuilt as v_j = min_i c_ij - u_i over those rows,
+ * and each column takes its minimising row while that row is free.  That
+ * is a dual-feasible, tight partial matching, so only the rows left over
+ * need an augmenting path and the result is still optimal.  Columns whose
+ * minimum is a cell >= big (inadmissible padding) are not seeded and keep
+ * v_j <= 0, so padding does not leak into the potentials.  u[0..n) is
+ * overwritten with the final row potentials.  Returns the number of rows
+ * the warm start matched.
+ */
+template<class T>
+inline int hungarian_warm(const T* cost, int n, double* u, const char* known,
+                          double big,
+                          std::vector<int>& rowsol,
+                          double& total_cost,
+                          HungarianWs& w)
+{
+    const double INF = std::numeric_limits<double>::infinity();
+    auto c = [&](int i, int j){ return double(cost[std::size_t(i)*n + j]); };
+    w.u.assign(n+1, 0.0); w.v.assign(n+1, INF);
+    w.p.assign(n+1, 0);   w.way.assign(n+1, 0);
+    w.used.assign(n+1, false);                      // row taken by the seed
+    for (int i=0;i<n;++i) if (known[i]) w.u[i+1] = u[i];
+
+    for (int i=0;i<n;++i) if (known[i]) {
+        const T* row = cost + std::size_t(i)*n;
+        for (int j=0;j<n;++j) {
+            const double r = double(row[j]) - w.u[i+1];
+            if (r < w.v[j+1]) { w.v[j+1] = r; w.p[j+1] = i+1; }
+        }
     }
+    int seeded = 0;
+    for (int j=1;j<=n;++j) {
+        if (w.v[j] == INF) { w.v[j] = 0.0; continue; }   // no known rows
+        if (c(w.p[j]-1, j-1) >= big) { w.v[j] = std::min(w.v[j], 0.0); w.p[j] = 0; continue; }
+        if (w.used[w.p[j]]) { w.p[j] = 0; continue; }
+        w.used[w.p[j]] = true; ++seeded;
+    }
+    w.rows.clear();                                     // augment() reuses used[]
+    for (int i=1;i<=n;++i) if (!w.used[i]) w.rows.push_back(i);
+    for (int i : w.rows) hungarian_detail::augment(n, i, c, w);
+
     rowsol.assign(n, -1);
-    for(int j=1;j<=n;++j) if(p[j]) rowsol[p[j]-1] = j-1;
-    total_cost = -v[0];
-    return 0;
+    for (int j=1;j<=n;++j) if (w.p[j]) rowsol[w.p[j]-1] = j-1;
+    total_cost = 0.0;
+    for (int i=0;i<n;++i) { total_cost += c(i, rowsol[i]); u[i] = w.u[i+1]; }
+    return seeded;
 }
@@ -0,0 +1,168 @@
+// iso_time.hpp - fixed-format ISO-8601 codecs without iostreams or locale.
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace iso {
+
+/** Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant). */
+constexpr std::int64_t days_from_civil(std::int64_t y, unsigned m, unsigned d)
+{
+    y -= m <= 2;
+    const std::int64_t era = (y >= 0 ? y : y-399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153*(m > 2 ? m-3 : m+9) + 2)/5 + d-1;
+    const unsigned doe = yoe * 365 + yoe/4 - yoe/100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+/** Proleptic Gregorian date of a day count since 1970-01-01 (inverse of the above). */
+struct Civil { std::int64_t y; unsigned m, d; };
+
+constexpr Civil civil_from_days(std::int64_t z)
+{
+    z += 719468;
+    const std::int64_t era = (z >= 0 ? z : z-146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
+    const unsigned doy = doe - (365*yoe + yoe/4 - yoe/100);
+    const unsigned mp  = (5*doy + 2)/153;
+    const unsigned d   = doy - (153*mp + 2)/5 + 1;
+    const unsigned m   = mp < 10 ? mp+3 : mp-9;
+    return {static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2), m, d};
+}
+
+/**
+ * Decode "YYYY-MM-DDTHH:MM:SS[.f...]" (UTC) in [b, e) to seconds since the
+ * epoch.  The fraction is digits / 10^n, which is correctly rounded and so
+ * equals std::stod("0.<digits>").  Returns false on anything else.
+ */
+inline bool decode(const char* b, const char* e, double& sec)
+{
+    auto num = [&](int at, int n, int& v) {
+        v = 0;
+        for (int i=0;i<n;++i) {
+            const char c = b[at+i];
+            if (c < '0' || c > '9') return false;
+            v = v*10 + (c-'0');
+        }
+        return true;
+    };
+    if (e - b < 19 || b[4]!='-' || b[7]!='-' || b[10]!='T' || b[13]!=':' || b[16]!=':')
+        return false;
+
+    int Y, M, D, h, m, s;
+    if (!num(0,4,Y) || !num(5,2,M) || !num(8,2,D) ||
+        !num(11,2,h) || !num(14,2,m) || !num(17,2,s)) return false;
+    if (M < 1 || M > 12 || D < 1 || D > 31) return false;
+
+    const std::int64_t whole = days_from_civil(Y, M, D)*86400 + h*3600 + m*60 + s;
+
+    double frac = 0.0;
+    const char* p = b + 19;
+    if (p < e && *p == '.') {
+        std::int64_t digits = 0; double scale = 1.0;
+        for (++p; p < e && *p >= '0' && *p <= '9' && scale < 1e17; ++p) {
+            digits = digits*10 + (*p-'0');
+            scale *= 10.0;
+        }
+        frac = static_cast<double>(digits) / scale;
+    }
+    sec = static_cast<double>(whole) + frac;
+    return true;
+}
+
+/** Seconds -> integer microseconds (rounded). */
+inline std::int64_t to_us(double sec)
+{
+    const double whole = std::floor(sec);
+    return static_cast<std::int64_t>(whole) * 1000000 +
+           std::llround((sec - whole) * 1e6);
+}
+
+/** Integer microseconds -> seconds, rounding like decode() does. */
+inline double from_us(std::int64_t us)
+{
+    std::int64_t s = us / 1000000, f = us % 1000000;
+    if (f < 0) { f += 1000000; --s; }
+    return static_cast<double>(s) + static_cast<double>(f) / 1e6;
+}
+
+/** Length of an encoded timestamp, "YYYY-MM-DDTHH:MM:SS.ffffff". */
+constexpr std::size_t encoded_size = 26;
+
+namespace detail {
+
+inline void digits(char* p, unsigned v, int n)
+{
+    for (int i = n-1; i >= 0; --i) { p[i] = static_cast<char>('0' + v % 10); v /= 10; }
+}
+
+/** "YYYY-MM-DDTHH:MM:SS" of a whole second since the epoch (years 0-9999). */
+inline void encode_second(std::int64_t sec, char* p)
+{
+    std::int64_t days = sec / 86400, rem = sec % 86400;
+    if (rem < 0) { rem += 86400; --days; }
+    const Civil c = civil_from_days(days);
+    const unsigned s = static_cast<unsigned>(rem);
+    digits(p, static_cast<unsigned>(c.y), 4); p[4]  = '-';
+    digits(p+5, c.m, 2);                      p[7]  = '-';
+    digits(p+8, c.d, 2);                      p[10] = 'T';
+    digits(p+11, s/3600, 2);                  p[13] = ':';
+    digits(p+14, s/60%60, 2);                 p[16] = ':';
+    digits(p+17, s%60, 2);
+}
+
+inline void split_us(std::int64_t us, std::int64_t& sec, unsigned& frac)
+{
+    sec = us / 1000000;
+    std::int64_t f = us % 1000000;
+    if (f < 0) { f += 1000000; --sec; }
+    frac = static_cast<unsigned>(f);
+}
+
+} // namespace detail
+
+/**
+ * Write integer microseconds since the epoch as "YYYY-MM-DDTHH:MM:SS.ffffff"
+ * (UTC, no terminator) to out[0, encoded_size); returns the end.  Years
+ * outside 0-9999 are not representable.
+ */
+inline char* encode(std::int64_t us, char* out)
+{
+    std::int64_t sec; unsigned frac;
+    detail::split_us(us, sec, frac);
+    detail::encode_second(sec, out);
+    out[19] = '.';
+    detail::digits(out + 20, frac, 6);
+    return out + encoded_size;
+}
+
+/**
+ * encode() for a run of mostly increasing timestamps: the date and time of
+ * the last second seen are kept, so frames of the same second only write
+ * the fraction.  One per writer; not shared between threads.
+ */
+class Formatter
+{
+public:
+    char* operator()(std::int64_t us, char* out)
+    {
+        std::int64_t sec; unsigned frac;
+        detail::split_us(us, sec, frac);
+        if (sec != sec_) { detail::encode_second(sec, prefix_); sec_ = sec; }
+        std::memcpy(out, prefix_, sizeof prefix_);
+        out[19] = '.';
+        detail::digits(out + 20, frac, 6);
+        return out + encoded_size;
+    }
+
+private:
+    std::int64_t sec_ = std::numeric_limits<std::int64_t>::min();
+    char         prefix_[19] = {};
+};
+
+} // namespace iso
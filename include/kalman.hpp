@@ -0,0 +1,96 @@
+// kalman.hpp - fixed-size constant-velocity Kalman filter for [x y w h] boxes.
+#pragma once
+#include <array>
+
+// The 8-state model [x y vx vy w h vw vh] with measurement [x y w h] has F, Q,
+// H, R and the initial P all block-diagonal over the pairs (x,vx) (y,vy)
+// (w,vw) (h,vh).  P therefore stays block-diagonal forever and the filter
+// splits into four independent 2-state filters with a symmetric 2x2
+// covariance each; no matrices, no heap.
+//
+// The per-axis kernels below are shared by ConstVelKF and by the batched
+// TrackStore kernels (as their scalar tail), so both paths round identically.
+
+namespace kf {
+
+constexpr double meas_noise = 1e-2;   // R = I * meas_noise
+constexpr double proc_noise = 1e-2;   // s in the white-accel Q
+
+/** Per-axis process noise for a step of dt. */
+template<class T>
+struct Noise { T q00, q01, q11; };
+
+template<class T>
+inline Noise<T> noise(T dt)
+{
+    const T pn = T(proc_noise);
+    const T dt2=dt*dt, dt3=dt2*dt, dt4=dt2*dt2;
+    return { dt4*T(0.25)*pn, dt3*T(0.5)*pn, dt2*pn };
+}
+
+/** x = F x,  P = F P F' + Q  with F = [[1 dt] [0 1]]. */
+template<class T>
+inline void predict_axis(T& p, T& v, T& P00, T& P01, T& P11,
+                         T dt, const Noise<T>& q)
+{
+    p += dt*v;
+    const T t00 = P00 + dt*P01,           // (F P) row 0
+            t01 = P01 + dt*P11;
+    P00 = t00 + dt*t01 + q.q00;
+    P01 = t01 + q.q01;
+    P11 = P11 + q.q11;
+}
+
+/** Standard update with H = [1 0]. */
+template<class T>
+inline void correct_axis(T& p, T& v, T& P00, T& P01, T& P11, T z)
+{
+    const T S  = P00 + T(meas_noise);
+    const T K0 = P00 / S, K1 = P01 / S;
+    const T r  = z - p;
+    p   += K0*r;
+    v   += K1*r;
+    P11 -= K1*P01;
+    P01 -= K0*P01;
+    P00 -= K0*P00;
+}
+
+} // namespace kf
+
+template<class T>
+struct BasicConstVelKF
+{
+    struct Axis
+    {
+        T p, v;                 // position, velocity
+        T P00, P01, P11;        // covariance [[P00 P01] [P01 P11]]
+    };
+
+    std::array<Axis,4> ax{};    // x, y, w, h
+
+    void init(T x, T y, T w, T h)
+    {
+        const T z[4] = {x, y, w, h};
+        for (int k=0;k<4;++k) ax[k] = {z[k], T(0), T(1), T(0), T(1)};
+    }
+
+    void predict(T dt)
+    {
+        const kf::Noise<T> q = kf::noise(dt);
+        for (auto& a : ax) kf::predict_axis(a.p, a.v, a.P00, a.P01, a.P11, dt, q);
+    }
+
+    void correct(T x, T y, T w, T h)
+    {
+        const T z[4] = {x, y, w, h};
+        for (int k=0;k<4;++k) {
+            Axis& a = ax[k];
+            kf::correct_axis(a.p, a.v, a.P00, a.P01, a.P11, z[k]);
+        }
+    }
+
+    std::array<T,4> rect() const { return {ax[0].p, ax[1].p, ax[2].p, ax[3].p}; }
+};
+
+using ConstVelKF  = BasicConstVelKF<double>;
+using ConstVelKFF = BasicConstVelKF<float>;
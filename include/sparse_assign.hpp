@@ -0,0 +1,209 @@
+// sparse_assign.hpp - gated rectangular assignment on a sparse cost graph.
+#pragma once
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include <utility>
+
+template<class T>
+struct BasicSparseEdge { int row, col; T cost; };   // cost >= 0
+using SparseEdge = BasicSparseEdge<double>;
+
+/**
+ * Reusable scratch for sparse_assign(); keep one per caller so repeated
+ * solves stop allocating once the buffers reach their high-water mark.
+ */
+struct SparseAssignWs
+{
+    // component split
+    std::vector<int> parent, comp_of_node, comp_start, comp_edges, local;
+    std::vector<int> comp_rows, comp_cols, cursor;
+    // per-component solver (CSR rows, columns = real + one dummy per row)
+    std::vector<int>    csr_start, csr_col, row_match, col_match, prev, touched;
+    std::vector<double> csr_cost, u, v, dist;
+    std::vector<char>   done;
+    std::vector<std::pair<double,int>> heap;
+};
+
+namespace sparse_detail {
+
+inline int find(std::vector<int>& p, int x)
+{
+    while (p[x] != x) { p[x] = p[p[x]]; x = p[x]; }
+    return x;
+}
+
+/**
+ * Min-cost maximum-cardinality matching of one connected component by
+ * successive shortest augmenting paths (the augmentation phase of
+ * Jonker–Volgenant) with Dijkstra over CSR rows.  Every row also owns a
+ * private dummy column priced above any achievable cost difference, so a
+ * row is left unmatched only when that lets more rows match overall –
+ * exactly the BIG-padding semantics of the dense solver.
+ */
+inline void solve_component(int nr, int nc, double dummy, SparseAssignWs& w)
+{
+    const int M = nc + nr;
+    const double INF = std::numeric_limits<double>::infinity();
+    w.row_match.assign(nr, -1);
+    w.col_match.assign(M, -1);
+    w.u.assign(nr, 0.0);
+    w.v.assign(M, 0.0);
+    w.dist.assign(M, INF);
+    w.prev.assign(M, -1);
+    w.done.assign(M, 0);
+
+    auto cmp = std::greater<std::pair<double,int>>();
+    for (int r=0; r<nr; ++r) {
+        w.heap.clear();
+        w.touched.clear();
+        auto relax = [&](int i, double base) {
+            for (int e=w.csr_start[i]; e<w.csr_start[i+1]; ++e) {
+                const int j = w.csr_col[e];
+                if (w.done[j]) continue;
+                const double nd = base + w.csr_cost[e] - w.u[i] - w.v[j];
+                if (nd < w.dist[j]) {
+                    if (w.dist[j] == INF) w.touched.push_back(j);
+                    w.dist[j] = nd; w.prev[j] = i;
+                    w.heap.push_back({nd,j}); std::push_heap(w.heap.begin(), w.heap.end(), cmp);
+                }
+            }
+            const int j = nc + i;                           // private dummy
+            const double nd = base + dummy - w.u[i] - w.v[j];
+            if (!w.done[j] && nd < w.dist[j]) {
+                if (w.dist[j] == INF) w.touched.push_back(j);
+                w.dist[j] = nd; w.prev[j] = i;
+                w.heap.push_back({nd,j}); std::push_heap(w.heap.begin(), w.heap.end(), cmp);
+            }
+        };
+
+        relax(r, 0.0);
+        int sink = -1; double dmin = 0.0;
+        while (!w.heap.empty()) {
+            std::pop_heap(w.heap.begin(), w.heap.end(), cmp);
+            const auto [d, j] = w.heap.back(); w.heap.pop_back();
+            if (w.done[j] || d > w.dist[j]) continue;
+            w.done[j] = 1;
+            if (w.col_match[j] == -1) { sink = j; dmin = d; break; }
+            relax(w.col_match[j], d);
+        }
+
+        // potentials: u_i += dmin - d_i, v_j -= dmin - d_j over finalised nodes
+        w.u[r] += dmin;
+        for (int j : w.touched) {
+            if (w.done[j]) {
+                const double delta = dmin - w.dist[j];
+                w.v[j] -= delta;
+                if (w.col_match[j] != -1) w.u[w.col_match[j]] += delta;
+            }
+            w.dist[j] = INF; w.done[j] = 0;
+        }
+
+        // augment along prev[]
+        for (int j=sink; j!=-1; ) {
+            const int i = w.prev[j], next = w.row_match[i];
+            w.col_match[j] = i; w.row_match[i] = j;
+            j = next;
+        }
+    }
+}
+
+} // namespace sparse_detail
+
+/**
+ * Gated assignment for an nrows x ncols problem given only the admissible
+ * (row, col, cost) pairs.  The graph is split into connected components;
+ * components with a single row or a single column take their cheapest edge
+ * directly and only the rest go through the augmenting-path solver.
+ * rowsol[r] is the matched column or -1.  Costs may be float or double;
+ * the solver works in double.
+ */
+template<class T>
+inline void sparse_assign(int nrows, int ncols,
+                          const std::vector<BasicSparseEdge<T>>& edges,
+                          std::vector<int>& rowsol,
+                          SparseAssignWs& w)
+{
+    rowsol.assign(nrows, -1);
+    if (edges.empty()) return;
+
+    // ─── union-find over rows [0,nrows) and cols [nrows, nrows+ncols) ──
+    const int nn = nrows + ncols;
+    w.parent.resize(nn);
+    std::iota(w.parent.begin(), w.parent.end(), 0);
+    for (const auto& e : edges) {
+        const int a = sparse_detail::find(w.parent, e.row),
+                  b = sparse_detail::find(w.parent, nrows + e.col);
+        if (a != b) w.parent[a] = b;
+    }
+
+    // ─── bucket edges by component (counting sort on the root) ──────
+    w.comp_of_node.assign(nn, -1);
+    int ncomp = 0;
+    for (const auto& e : edges) {
+        const int root = sparse_detail::find(w.parent, e.row);
+        if (w.comp_of_node[root] == -1) w.comp_of_node[root] = ncomp++;
+    }
+    w.comp_start.assign(ncomp + 1, 0);
+    for (const auto& e : edges)
+        ++w.comp_start[w.comp_of_node[sparse_detail::find(w.parent, e.row)] + 1];
+    for (int c=0; c<ncomp; ++c) w.comp_start[c+1] += w.comp_start[c];
+    w.comp_edges.resize(edges.size());
+    w.cursor.assign(w.comp_start.begin(), w.comp_start.end());
+    for (int k=0; k<static_cast<int>(edges.size()); ++k) {
+        const int c = w.comp_of_node[sparse_detail::find(w.parent, edges[k].row)];
+        w.comp_edges[w.cursor[c]++] = k;
+    }
+
+    // ─── solve each component ───────────────────────────────────────
+    w.local.assign(nn, -1);
+    for (int c=0; c<ncomp; ++c) {
+        const int e0 = w.comp_start[c], e1 = w.comp_start[c+1];
+
+        // local numbering of rows / cols in this component
+        w.comp_rows.clear(); w.comp_cols.clear();
+        for (int k=e0; k<e1; ++k) {
+            const auto& e = edges[w.comp_edges[k]];
+            if (w.local[e.row] == -1)         { w.local[e.row] = static_cast<int>(w.comp_rows.size()); w.comp_rows.push_back(e.row); }
+            if (w.local[nrows+e.col] == -1)   { w.local[nrows+e.col] = static_cast<int>(w.comp_cols.size()); w.comp_cols.push_back(e.col); }
+        }
+        const int nr = static_cast<int>(w.comp_rows.size()),
+                  nc = static_cast<int>(w.comp_cols.size());
+
+        if (nr == 1 || nc == 1) {
+            // star (incl. 1x1): one match, the cheapest edge wins
+            int best = w.comp_edges[e0];
+            for (int k=e0+1; k<e1; ++k)
+                if (edges[w.comp_edges[k]].cost < edges[best].cost) best = w.comp_edges[k];
+            rowsol[edges[best].row] = edges[best].col;
+        }
+        else {
+            // CSR by local row; dummy price exceeds any matching's cost
+            w.csr_start.assign(nr + 1, 0);
+            double dummy = 1.0;
+            for (int k=e0; k<e1; ++k) {
+                const auto& e = edges[w.comp_edges[k]];
+                ++w.csr_start[w.local[e.row] + 1];
+                dummy += e.cost;
+            }
+            for (int r=0; r<nr; ++r) w.csr_start[r+1] += w.csr_start[r];
+            w.csr_col.resize(e1 - e0); w.csr_cost.resize(e1 - e0);
+            w.cursor.assign(w.csr_start.begin(), w.csr_start.end());
+            for (int k=e0; k<e1; ++k) {
+                const auto& e = edges[w.comp_edges[k]];
+                const int slot = w.cursor[w.local[e.row]]++;
+                w.csr_col[slot]  = w.local[nrows + e.col];
+                w.csr_cost[slot] = e.cost;
+            }
+
+            sparse_detail::solve_component(nr, nc, dummy, w);
+            for (int r=0; r<nr; ++r)
+                if (w.row_match[r] < nc) rowsol[w.comp_rows[r]] = w.comp_cols[w.row_match[r]];
+        }
+
+        for (int r : w.comp_rows) w.local[r] = -1;
+        for (int col : w.comp_cols) w.local[nrows + col] = -1;
+    }
+}
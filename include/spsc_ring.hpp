@@ -0,0 +1,92 @@
+// spsc_ring.hpp - bounded lock-free single-producer / single-consumer ring.
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed ring of pre-constructed slots.  The producer fills a slot in place
+ * (producer_slot / push) and the consumer reads it in place (front / pop),
+ * so slot contents – and the capacity of any vectors inside them – are
+ * recycled instead of moved or reallocated.  head_ and tail_ sit on their
+ * own cache lines; each side only writes its own index.
+ *
+ * close() marks the end of the stream: front() keeps returning queued
+ * slots and returns nullptr only once the ring is closed and drained.
+ */
+template<class T>
+class SpscRing
+{
+public:
+    explicit SpscRing(std::size_t capacity)
+    {
+        std::size_t n = 2;
+        while (n < capacity) n <<= 1;
+        buf_.resize(n);
+        mask_ = n - 1;
+    }
+
+    SpscRing(const SpscRing&)            = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // ─── producer ───────────────────────────────────────────────────
+    /** Next free slot, or nullptr when the ring is full. */
+    T* try_producer_slot()
+    {
+        const std::size_t t = tail_.load(std::memory_order_relaxed);
+        if (t - head_.load(std::memory_order_acquire) > mask_) return nullptr;
+        return &buf_[t & mask_];
+    }
+
+    /** Next free slot, waiting while the ring is full. */
+    T* producer_slot()
+    {
+        T* s;
+        for (int spin=0; !(s = try_producer_slot()); ++spin) backoff(spin);
+        return s;
+    }
+
+    /** Publish the slot returned by producer_slot(). */
+    void push() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    /** No more pushes follow. */
+    void close() { closed_.store(true, std::memory_order_release); }
+
+    // ─── consumer ───────────────────────────────────────────────────
+    /** Oldest published slot, or nullptr when the ring is empty. */
+    T* try_front()
+    {
+        const std::size_t h = head_.load(std::memory_order_relaxed);
+        if (h == tail_.load(std::memory_order_acquire)) return nullptr;
+        return &buf_[h & mask_];
+    }
+
+    /** Oldest published slot, waiting for one; nullptr once closed and drained. */
+    T* front()
+    {
+        for (int spin=0;; ++spin) {
+            if (T* s = try_front()) return s;
+            if (closed_.load(std::memory_order_acquire))
+                return try_front();               // pushes before close() are visible now
+            backoff(spin);
+        }
+    }
+
+    /** Release the slot returned by front() back to the producer. */
+    void pop() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+private:
+    static void backoff(int spin)
+    {
+        if (spin > 64) std::this_thread::yield();
+    }
+
+    std::vector<T> buf_;
+    std::size_t    mask_ = 0;
+    alignas(64) std::atomic<std::size_t> head_{0};   // consumer-owned
+    alignas(64) std::atomic<std::size_t> tail_{0};   // producer-owned
+    alignas(64) std::atomic<bool>        closed_{false};
+};
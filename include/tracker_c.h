@@ -0,0 +1,129 @@
+/*
+ * tracker_c.h - plain C ABI of the tracker library (libtracker.a / .so).
+ *
+ * Lets a detector process track in-process, frame by frame, with no
+ * serialisation: tracker_step() reads the caller's contiguous detection
+ * array in place and writes labels into the caller's label array.
+ *
+ *     tracker_params p;
+ *     tracker_params_default(&p);
+ *     p.assigner = TRACKER_ASSIGN_SPARSE;
+ *     tracker* t = tracker_create(&p);
+ *     ...
+ *     size_t n_labels;
+ *     if (tracker_step(t, ts, dets, n, labels, cap, &n_labels) != TRACKER_OK) ...
+ *     ...
+ *     tracker_destroy(t);
+ *
+ * The layouts below never change within an ABI version.  A tracker is
+ * not thread-safe, but independent trackers may be stepped concurrently.
+ */
+#ifndef TRACKER_C_H
+#define TRACKER_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRACKER_ABI_VERSION 1
+
+/** Normalised box, identical to the C++ Detection (four doubles). */
+typedef struct tracker_detection
+{
+    double x, y, w, h;
+} tracker_detection;
+
+/** One output label: the track id given to a detection. */
+typedef struct tracker_label
+{
+    int32_t           track_id;
+    int32_t           reserved;   /* padding, unspecified */
+    tracker_detection det;        /* the detection, as passed in */
+} tracker_label;
+
+enum tracker_assigner
+{
+    TRACKER_ASSIGN_DENSE   = 0,   /* N x N Hungarian */
+    TRACKER_ASSIGN_SPARSE  = 1,   /* gated components */
+    TRACKER_ASSIGN_CASCADE = 2    /* greedy fast path, Hungarian on the rest */
+};
+
+typedef struct tracker_params
+{
+    double  max_dist;             /* centre-distance gate */
+    int32_t max_age;              /* frames a lost track is kept */
+    double  alpha;                /* IoU weight in the association cost */
+    int32_t assigner;             /* enum tracker_assigner */
+    int32_t warm_start;           /* dense: reuse last frame's duals (0/1) */
+    double  fast_iou;             /* cascade: greedy IoU threshold */
+    int32_t single_precision;     /* 1: float core, 0: double */
+} tracker_params;
+
+enum tracker_status
+{
+    TRACKER_OK      =  0,
+    TRACKER_EINVAL  = -1,         /* null handle / buffer, bad parameter */
+    TRACKER_ENOSPC  = -2,         /* label buffer smaller than n */
+    TRACKER_EFAIL   = -3          /* internal error (e.g. out of memory) */
+};
+
+/** ABI version the library was built with (TRACKER_ABI_VERSION). */
+int tracker_abi_version(void);
+
+/** Fill p with the defaults of tracking-solution. */
+void tracker_params_default(tracker_params* p);
+
+/** New tracker; NULL params means defaults.  NULL on bad params or OOM. */
+typedef struct tracker tracker;
+tracker* tracker_create(const tracker_params* p);
+
+void tracker_destroy(tracker* t);
+
+/**
+ * Track one frame of n detections taken at ts (seconds, any epoch, non-
+ * decreasing).  Labels come in input order, at most one per detection,
+ * so a capacity >= n always suffices; with less, nothing is done and
+ * TRACKER_ENOSPC is returned.  *n_labels receives the count written:
+ * n, unless a track limit left some detections without a track.
+ */
+int tracker_step(tracker* t, double ts,
+                 const tracker_detection* dets, size_t n,
+                 tracker_label* labels, size_t capacity, size_t* n_labels);
+
+/** Tracks currently alive (matched or coasting). */
+size_t tracker_track_count(const tracker* t);
+
+/**
+ * Keep at most max_tracks tracks alive (0: unbounded, the default); see
+ * Tracker::set_track_limit.  Storage for them is reserved here, so later
+ * steps never allocate for new tracks.  TRACKER_EINVAL if max_tracks
+ * exceeds UINT32_MAX.
+ */
+int tracker_set_max_tracks(tracker* t, size_t max_tracks);
+
+/**
+ * Snapshot the full tracker state (see Tracker::save) into buf.  *size
+ * receives the snapshot's length; with capacity below it nothing is
+ * written and TRACKER_ENOSPC is returned, so a first call with capacity
+ * 0 sizes the buffer.
+ */
+int tracker_save(const tracker* t, void* buf, size_t capacity, size_t* size);
+
+/**
+ * Replace t's state with a snapshot from tracker_save().  The snapshot
+ * must come from a tracker of the same precision; on any error t is
+ * unchanged and TRACKER_EINVAL is returned.
+ */
+int tracker_restore(tracker* t, const void* buf, size_t size);
+
+/** Static description of a tracker_status. */
+const char* tracker_strerror(int status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACKER_C_H */
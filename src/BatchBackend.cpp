@@ -0,0 +1,60 @@
+#include "BatchBackend.hpp"
+#include <iostream>
+#include <stdexcept>
+
+#ifdef TRACKER_OPENCL
+// OclBackend.cpp
+bool ocl_usable(std::string& why);
+std::unique_ptr<BatchBackend> make_ocl_backend();
+#endif
+
+namespace {
+
+class CpuBackend final : public BatchBackend
+{
+public:
+    const char* name() const override { return "cpu"; }
+
+    void predict_gate(Tracker* const* t, std::size_t n, metrics::Registry&) override
+    {
+        for (std::size_t i=0; i<n; ++i) { t[i]->predict(); t[i]->gate(); }
+    }
+
+    void correct(Tracker* const* t, std::size_t n, metrics::Registry&) override
+    {
+        for (std::size_t i=0; i<n; ++i) t[i]->correct();
+    }
+};
+
+} // namespace
+
+std::string resolve_backend(const std::string& name)
+{
+    if (name == "cpu") return name;
+    if (name != "opencl") throw std::invalid_argument("unknown backend '" + name + "' (cpu | opencl)");
+#ifdef TRACKER_OPENCL
+    std::string why;
+    if (ocl_usable(why)) return name;
+    std::cerr << "opencl backend unavailable (" << why << "); using cpu\n";
+    return "cpu";
+#else
+    throw std::invalid_argument("opencl backend was not built in (TRACKER_OPENCL)");
+#endif
+}
+
+std::unique_ptr<BatchBackend> make_backend(const std::string& name)
+{
+#ifdef TRACKER_OPENCL
+    if (name == "opencl") return make_ocl_backend();
+#endif
+    if (name == "cpu") return std::make_unique<CpuBackend>();
+    throw std::invalid_argument("no backend '" + name + "'");
+}
+
+void step_batch(BatchBackend& b, Tracker* const* t, std::size_t n, metrics::Registry& m)
+{
+    b.predict_gate(t, n, m);
+    for (std::size_t i=0; i<n; ++i) t[i]->associate();
+    b.correct(t, n, m);
+    m.add(metrics::BatchedSteps, n);
+}
@@ -0,0 +1,213 @@
+#include "BinaryFormat.hpp"
+#include "iso_time.hpp"
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+// ───────────────── header helpers ───────────────────────────────────
+namespace {
+
+struct LabelRec64 { std::int32_t id; std::uint32_t pad; double x, y, w, h; };
+struct LabelRec32 { std::int32_t id; float x, y, w, h; };
+struct DetRec32   { float x, y, w, h; };
+static_assert(sizeof(LabelRec64) == 40 && sizeof(LabelRec32) == 20 &&
+              sizeof(DetRec32) == 16, "binary layout");
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#  error "binary streams are little-endian; add byte swapping for this target"
+#endif
+
+bool open_stream(const MappedFile& f, const char (&magic)[4],
+                 const char*& p, const char*& end, bool& f32, bool& streams)
+{
+    p = f.data(); end = f.data() + f.size();
+    if (f.size() < sizeof(bin::FileHeader)) return false;
+
+    bin::FileHeader h;
+    std::memcpy(&h, p, sizeof h);
+    if (std::memcmp(h.magic, magic, 4) != 0) return false;
+    if (h.version != bin::version)
+        throw std::runtime_error("unsupported binary stream version " + std::to_string(h.version));
+    f32     = (h.flags & bin::flag_f32) != 0;
+    streams = (h.flags & bin::flag_streams) != 0;
+    p      += sizeof h;
+    return true;
+}
+
+void write_file_header(std::ostream& out, const char (&magic)[4], bool f32, bool streams)
+{
+    bin::FileHeader h{};
+    std::memcpy(h.magic, magic, 4);
+    h.version = bin::version;
+    h.flags   = static_cast<std::uint16_t>((f32 ? bin::flag_f32 : 0) | (streams ? bin::flag_streams : 0));
+    out.write(reinterpret_cast<const char*>(&h), sizeof h);
+}
+
+/**
+ * Next frame header (and stream tag), checked against the mapping; false
+ * at the end.  rec is left pointing at the first record.
+ */
+bool frame_header(const char* p, const char* end, std::size_t rec_size, bool streams,
+                  bin::FrameHeader& h, std::uint32_t& stream, const char*& rec)
+{
+    if (p == end) return false;
+    const std::size_t head = sizeof h + (streams ? sizeof(bin::StreamTag) : 0);
+    if (static_cast<std::size_t>(end - p) < head)
+        throw std::runtime_error("truncated binary frame header");
+    std::memcpy(&h, p, sizeof h);
+    if (h.bytes < head + std::size_t(h.count) * rec_size ||
+        h.bytes > static_cast<std::size_t>(end - p))
+        throw std::runtime_error("corrupt binary frame record");
+    stream = 0;
+    if (streams) {
+        bin::StreamTag t; std::memcpy(&t, p + sizeof h, sizeof t);
+        stream = t.stream;
+    }
+    rec = p + head;
+    return true;
+}
+
+template<class T>
+void put(std::vector<char>& buf, const T& v)
+{
+    const char* c = reinterpret_cast<const char*>(&v);
+    buf.insert(buf.end(), c, c + sizeof v);
+}
+
+void put_frame_header(std::vector<char>& buf, double ts, std::size_t n, std::size_t rec_size,
+                      bool streams, std::uint32_t stream)
+{
+    const std::size_t head = sizeof(bin::FrameHeader) + (streams ? sizeof(bin::StreamTag) : 0);
+    put(buf, bin::FrameHeader{static_cast<std::uint32_t>(head + n*rec_size),
+                              static_cast<std::uint32_t>(n), iso::to_us(ts)});
+    if (streams) put(buf, bin::StreamTag{stream, 0u});
+}
+
+} // namespace
+
+// ───────────────── sniffing ─────────────────────────────────────────
+bin::Kind bin::sniff(const char* data, std::size_t size)
+{
+    if (size < 4) return Kind::None;
+    if (std::memcmp(data, frames_magic, 4) == 0) return Kind::Frames;
+    if (std::memcmp(data, labels_magic, 4) == 0) return Kind::Labels;
+    if (std::memcmp(data, quant_magic, 4)  == 0) return Kind::QuantLabels;
+    return Kind::None;
+}
+
+bin::Kind bin::sniff_file(const std::string& path)
+{
+    std::ifstream f(path, std::ios::binary);
+    char m[4] = {};
+    f.read(m, 4);
+    return sniff(m, static_cast<std::size_t>(f.gcount()));
+}
+
+// ───────────────── frames ───────────────────────────────────────────
+BinaryFrameReader::BinaryFrameReader(const std::string& path) : file_(path)
+{
+    if (!open_stream(file_, bin::frames_magic, p_, end_, f32_, streams_))
+        throw std::runtime_error(path + " is not a binary frame stream");
+}
+
+bool BinaryFrameReader::next_view(FrameView& v)
+{
+    bin::FrameHeader h; const char* rec;
+    if (!frame_header(p_, end_, f32_ ? sizeof(DetRec32) : sizeof(Detection), streams_,
+                      h, v.stream, rec)) return false;
+    v.ts = iso::from_us(h.ts_us);
+    v.n  = h.count;
+
+    if (!f32_) v.dets = reinterpret_cast<const Detection*>(rec);   // in place
+    else {
+        scratch_.dets.resize(h.count);
+        for (std::uint32_t i=0; i<h.count; ++i) {
+            DetRec32 r; std::memcpy(&r, rec + i*sizeof r, sizeof r);
+            scratch_.dets[i] = {r.x, r.y, r.w, r.h};
+        }
+        v.dets = scratch_.dets.data();
+    }
+    p_ += h.bytes;
+    return true;
+}
+
+bool BinaryFrameReader::next(Frame& fr)
+{
+    FrameView v;
+    if (!next_view(v)) return false;
+    fr.ts     = v.ts;
+    fr.stream = v.stream;
+    fr.dets.assign(v.dets, v.dets + v.n);
+    return true;
+}
+
+BinaryFrameWriter::BinaryFrameWriter(std::ostream& out, bool f32, bool streams)
+    : out_(out), f32_(f32), streams_(streams)
+{
+    write_file_header(out_, bin::frames_magic, f32_, streams_);
+}
+
+void BinaryFrameWriter::write(double ts, const Detection* dets, std::size_t n,
+                              std::uint32_t stream)
+{
+    buf_.clear();
+    put_frame_header(buf_, ts, n, f32_ ? sizeof(DetRec32) : sizeof(Detection), streams_, stream);
+    for (std::size_t i=0; i<n; ++i) {
+        const Detection& d = dets[i];
+        if (f32_) put(buf_, DetRec32{float(d.x), float(d.y), float(d.w), float(d.h)});
+        else      put(buf_, d);
+    }
+    out_.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+}
+
+// ───────────────── labels ───────────────────────────────────────────
+BinaryLabelWriter::BinaryLabelWriter(std::ostream& out, bool f32, bool streams)
+    : out_(out), f32_(f32), streams_(streams)
+{
+    write_file_header(out_, bin::labels_magic, f32_, streams_);
+}
+
+void BinaryLabelWriter::write_stream(std::uint32_t stream, double ts,
+                                     const std::vector<Label>& labels)
+{
+    buf_.clear();
+    put_frame_header(buf_, ts, labels.size(), f32_ ? sizeof(LabelRec32) : sizeof(LabelRec64),
+                     streams_, stream);
+    for (const Label& L : labels) {
+        const Detection& d = L.det;
+        if (f32_) put(buf_, LabelRec32{L.track_id, float(d.x), float(d.y), float(d.w), float(d.h)});
+        else      put(buf_, LabelRec64{L.track_id, 0u, d.x, d.y, d.w, d.h});
+    }
+    out_.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+    out_.flush();
+}
+
+void BinaryLabelWriter::finish() { out_.flush(); }
+
+BinaryLabelReader::BinaryLabelReader(const std::string& path) : file_(path)
+{
+    if (!open_stream(file_, bin::labels_magic, p_, end_, f32_, streams_))
+        throw std::runtime_error(path + " is not a binary label stream");
+}
+
+bool BinaryLabelReader::next(double& ts, std::vector<Label>& labels, std::uint32_t* stream)
+{
+    bin::FrameHeader h; const char* rec; std::uint32_t id;
+    if (!frame_header(p_, end_, f32_ ? sizeof(LabelRec32) : sizeof(LabelRec64), streams_,
+                      h, id, rec)) return false;
+    if (stream) *stream = id;
+    ts = iso::from_us(h.ts_us);
+    labels.resize(h.count);
+    for (std::uint32_t i=0; i<h.count; ++i) {
+        if (f32_) {
+            LabelRec32 r; std::memcpy(&r, rec + i*sizeof r, sizeof r);
+            labels[i] = {r.id, {r.x, r.y, r.w, r.h}};
+        } else {
+            LabelRec64 r; std::memcpy(&r, rec + i*sizeof r, sizeof r);
+            labels[i] = {r.id, {r.x, r.y, r.w, r.h}};
+        }
+    }
+    p_ += h.bytes;
+    return true;
+}
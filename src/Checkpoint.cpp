@@ -0,0 +1,180 @@
+#include "Checkpoint.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// ───────────────── checkpoints ──────────────────────────────────────
+void save_checkpoint(const std::string& path, const Tracker& t)
+{
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary);
+        if (!f) throw std::runtime_error("cannot write checkpoint " + tmp);
+        t.save(f);
+        f.flush();
+        if (!f) throw std::runtime_error("cannot write checkpoint " + tmp);
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+        throw std::runtime_error("cannot replace checkpoint " + path);
+}
+
+void load_checkpoint(const std::string& path, Tracker& t)
+{
+    std::ifstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error("cannot open checkpoint " + path);
+    try { t.restore(f); }
+    catch (const std::exception& e) { throw std::runtime_error(path + ": " + e.what()); }
+}
+
+bool ResumeSource::next(Frame& fr)
+{
+    while (src_->next(fr)) if (!(fr.ts <= after_)) return true;
+    return false;
+}
+
+bool ResumeSource::next_view(FrameView& v)
+{
+    while (src_->next_view(v)) if (!(v.ts <= after_)) return true;
+    return false;
+}
+
+// ───────────────── chunked runs ─────────────────────────────────────
+ChunkOptions ChunkOptions::from(const Config& cfg)
+{
+    ChunkOptions o;
+    cfg.read("pipeline", "workers", o.workers);
+    cfg.read("pipeline", "chunks",  o.chunks);
+    cfg.read("pipeline", "overlap", o.overlap);
+    return o;
+}
+
+namespace {
+
+struct Chunk
+{
+    std::size_t warm, begin, end;               // frames [warm, end), output [begin, end)
+    std::vector<std::vector<Label>> labels;     // per frame of [warm, end), chunk-local ids
+    metrics::Registry               metrics;
+};
+
+/**
+ * Rewrite chunk c's ids to global ones.  `prev` points at the global
+ * labels of frames [c.warm, c.begin), as output by the previous chunk; both
+ * trackers label every detection in input order, so label i of a shared
+ * frame names the same detection on both sides.
+ */
+std::size_t stitch(Chunk& c, const std::vector<Label>* prev, int& next_global)
+{
+    std::unordered_map<int,int> to_global;
+    std::unordered_set<int>     taken;
+    for (std::size_t f = c.begin; f-- > c.warm; ) {
+        const auto& local  = c.labels[f - c.warm];
+        const auto& global = prev[f - c.warm];
+        for (std::size_t i=0; i<local.size() && i<global.size(); ++i) {
+            const int L = local[i].track_id, G = global[i].track_id;
+            if (to_global.count(L) || taken.count(G)) continue;
+            to_global.emplace(L, G);
+            taken.insert(G);
+        }
+    }
+    const std::size_t carried = to_global.size();
+    for (std::size_t f = c.begin; f < c.end; ++f)
+        for (Label& l : c.labels[f - c.warm]) {
+            auto it = to_global.find(l.track_id);
+            if (it == to_global.end()) it = to_global.emplace(l.track_id, next_global++).first;
+            l.track_id = it->second;
+        }
+    return carried;
+}
+
+} // namespace
+
+std::size_t run_chunked(FrameSource& src, const Tracker& prototype, LabelSink& sink,
+                        const ChunkOptions& opt, metrics::Registry* m)
+{
+    metrics::Registry io;
+    std::vector<Frame> frames;
+    for (;;) {
+        metrics::Scoped t(io, metrics::Parse);
+        frames.emplace_back();
+        if (!src.next(frames.back())) { frames.pop_back(); break; }
+    }
+    const std::size_t nf = frames.size();
+    if (nf == 0) { if (m) m->merge(io); return 0; }
+
+    const unsigned nw = opt.workers ? opt.workers
+                                    : std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t nc = std::min(nf, opt.chunks ? opt.chunks : std::size_t(nw));
+    std::vector<Chunk> chunks(nc);
+    for (std::size_t k=0; k<nc; ++k) {
+        Chunk& c = chunks[k];
+        c.begin = nf * k / nc;
+        c.end   = nf * (k+1) / nc;
+        // warm up inside the previous chunk only, so stitching sees its labels
+        c.warm  = k == 0 ? 0 : std::max(chunks[k-1].begin, c.begin - std::min(c.begin, opt.overlap));
+    }
+
+    // ─── track every chunk in parallel ──────────────────────────────
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr       err;
+    std::mutex               err_m;
+    auto work = [&] {
+        try {
+            for (std::size_t k; (k = next.fetch_add(1)) < nc; ) {
+                Chunk& c = chunks[k];
+                Tracker tracker(prototype);
+                c.labels.resize(c.end - c.warm);
+                for (std::size_t f = c.warm; f < c.end; ++f)
+                    c.labels[f - c.warm] = tracker.step(frames[f].ts, frames[f].dets);
+                c.metrics = tracker.metrics();
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lk(err_m);
+            if (!err) err = std::current_exception();
+            next = nc;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned i=1; i<std::min<std::size_t>(nw, nc); ++i) threads.emplace_back(work);
+    work();
+    for (auto& t : threads) t.join();
+    if (err) std::rethrow_exception(err);
+
+    // ─── stitch ids at the boundaries, write in frame order ────────
+    int next_global = 0;
+    for (const auto& fl : chunks[0].labels)
+        for (const Label& l : fl) next_global = std::max(next_global, l.track_id + 1);
+
+    metrics::Registry total;
+    std::size_t carried = 0;
+    for (std::size_t k=0; k<nc; ++k) {
+        Chunk& c = chunks[k];
+        if (k > 0) {
+            const Chunk& p = chunks[k-1];
+            carried += stitch(c, p.labels.data() + (c.warm - p.warm), next_global);
+        }
+        for (std::size_t f = c.begin; f < c.end; ++f) {
+            metrics::Scoped t(io, metrics::Write);
+            sink.write(frames[f].ts, c.labels[f - c.warm]);
+        }
+        total.merge(c.metrics);
+        total.tracks_alive = c.metrics.tracks_alive;     // the last chunk's tracker
+        if (k >= 1) std::vector<std::vector<Label>>().swap(chunks[k-1].labels);
+    }
+
+    if (m) {
+        total.add(metrics::Stitched, carried);
+        total.merge(io);
+        m->merge(total);
+    }
+    return nf;
+}
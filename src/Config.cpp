@@ -0,0 +1,99 @@
+#include "Config.hpp"
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::string_view trim(std::string_view s)
+{
+    const auto ws = [](char c){ return c == ' ' || c == '\t' || c == '\r' || c == '\n'; };
+    while (!s.empty() && ws(s.front())) s.remove_prefix(1);
+    while (!s.empty() && ws(s.back()))  s.remove_suffix(1);
+    return s;
+}
+
+/** Text before a `#` / `;` comment. */
+std::string_view uncomment(std::string_view s)
+{
+    const auto c = s.find_first_of("#;");
+    return c == std::string_view::npos ? s : s.substr(0, c);
+}
+
+template<class T>
+bool number(const std::string& s, T& v)
+{
+    T x{};
+    const auto r = std::from_chars(s.data(), s.data() + s.size(), x);
+    if (r.ec != std::errc() || r.ptr != s.data() + s.size()) return false;
+    v = x;
+    return true;
+}
+
+} // namespace
+
+Config Config::load(const std::string& path)
+{
+    std::ifstream f(path, std::ios::binary);
+    if (!f) { Config c; c.origin_ = path; return c; }
+    std::ostringstream text;
+    text << f.rdbuf();
+    return parse(text.str(), path);
+}
+
+Config Config::parse(std::string_view text, std::string origin)
+{
+    Config c;
+    c.origin_ = std::move(origin);
+    std::map<std::string, std::string>* cur = nullptr;
+    while (!text.empty()) {
+        const auto nl = text.find('\n');
+        std::string_view line = trim(text.substr(0, nl));
+        text.remove_prefix(nl == std::string_view::npos ? text.size() : nl + 1);
+
+        if (line.empty() || line.front() == '#' || line.front() == ';') continue;
+        if (line.front() == '[') {
+            const auto close = line.find(']');
+            if (close != std::string_view::npos && trim(uncomment(line.substr(close + 1))).empty()) {
+                cur = &c.sections_[std::string(trim(line.substr(1, close - 1)))];
+                continue;
+            }
+        }
+        const auto eq = line.find('=');
+        if (!cur || eq == std::string_view::npos) continue;
+        const std::string_view key = trim(line.substr(0, eq));
+        if (key.empty()) continue;
+        cur->emplace(std::string(key), std::string(trim(uncomment(line.substr(eq + 1)))));
+    }
+    return c;
+}
+
+const std::string* Config::find(const std::string& sec, const std::string& key) const
+{
+    const auto s = sections_.find(sec);
+    if (s == sections_.end()) return nullptr;
+    const auto k = s->second.find(key);
+    return k == s->second.end() ? nullptr : &k->second;
+}
+
+bool Config::convert(const std::string& s, bool& v)
+{
+    if (s == "true"  || s == "on"  || s == "yes" || s == "1") { v = true;  return true; }
+    if (s == "false" || s == "off" || s == "no"  || s == "0") { v = false; return true; }
+    return false;
+}
+
+bool Config::convert(const std::string& s, int& v)                { return number(s, v); }
+bool Config::convert(const std::string& s, long& v)               { return number(s, v); }
+bool Config::convert(const std::string& s, long long& v)          { return number(s, v); }
+bool Config::convert(const std::string& s, unsigned& v)           { return number(s, v); }
+bool Config::convert(const std::string& s, unsigned long& v)      { return number(s, v); }
+bool Config::convert(const std::string& s, unsigned long long& v) { return number(s, v); }
+bool Config::convert(const std::string& s, float& v)              { return number(s, v); }
+bool Config::convert(const std::string& s, double& v)             { return number(s, v); }
+
+void Config::bad_value(const std::string& sec, const std::string& key, const std::string& value) const
+{
+    throw std::invalid_argument(origin_ + ": [" + sec + "] " + key + ": cannot parse '" + value + "'");
+}
@@ -0,0 +1,171 @@
+#include "FrameIO.hpp"
+#include "BinaryFormat.hpp"
+#include "iso_time.hpp"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <iostream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+// ───────────────── timestamps ───────────────────────────────────────
+double parse_iso(std::string_view s)
+{
+    double sec;
+    if (!iso::decode(s.data(), s.data() + s.size(), sec))
+        throw std::runtime_error("bad timestamp '" + std::string(s) + "'");
+    return sec;
+}
+
+std::string format_iso(double sec)
+{
+    char buf[iso::encoded_size];
+    return std::string(buf, iso::encode(iso::to_us(sec), buf));
+}
+
+// ───────────────── reader ───────────────────────────────────────────
+bool JsonObjectStream::next(std::string& obj)
+{
+    std::streambuf* sb = in_.rdbuf();
+    obj.clear();
+
+    // skip '[', ',', ']' and whitespace up to the next top-level '{'
+    int c;
+    while ((c = sb->sbumpc()) != EOF && c != '{') {}
+    if (c == EOF) return false;
+
+    int  depth = 0;
+    bool str = false, esc = false;
+    do {
+        obj.push_back(static_cast<char>(c));
+        if (str) {
+            if      (esc)       esc = false;
+            else if (c == '\\') esc = true;
+            else if (c == '"')  str = false;
+        }
+        else if (c == '"') str = true;
+        else if (c == '{') ++depth;
+        else if (c == '}' && --depth == 0) return true;
+    } while ((c = sb->sbumpc()) != EOF);
+
+    throw std::runtime_error("truncated object in JSON input");
+}
+
+bool JsonFrameReader::next(Frame& fr)
+{
+    if (!objs_.next(buf_)) return false;
+
+    const auto f = nlohmann::json::parse(buf_);
+    fr.ts     = parse_iso(f["timestamp"].get_ref<const std::string&>());
+    fr.stream = f.value("stream", 0u);
+    fr.dets.clear();
+    for (auto& d : f["detections"])
+        fr.dets.push_back({d["x"], d["y"], d["w"], d["h"]});
+    return true;
+}
+
+// ───────────────── sources ──────────────────────────────────────────
+namespace {
+
+class JsonFileReader : public FrameSource
+{
+public:
+    explicit JsonFileReader(const std::string& path) : f_(path), r_(f_)
+    {
+        if (!f_) throw std::runtime_error("cannot open input " + path);
+    }
+    bool next(Frame& fr) override { return r_.next(fr); }
+
+private:
+    std::ifstream   f_;
+    JsonFrameReader r_;
+};
+
+} // namespace
+
+std::unique_ptr<FrameSource> open_frames(const std::string& path,
+                                         const std::string& ingest)
+{
+    if (path == "-")        return std::make_unique<JsonFrameReader>(std::cin);
+    if (bin::sniff_file(path) == bin::Kind::Frames)
+                            return std::make_unique<BinaryFrameReader>(path);
+    if (ingest == "stream") return std::make_unique<JsonFileReader>(path);
+    return std::make_unique<MappedJsonFrameReader>(path);
+}
+
+// ───────────────── writer ───────────────────────────────────────────
+void JsonFrameWriter::write_stream(std::uint32_t stream, double ts,
+                                   const std::vector<Label>& labels)
+{
+    // build output object with RAW rectangle
+    nlohmann::ordered_json obj;
+    if (streams_) obj["stream"] = stream;
+    obj["timestamp"] = stamp(ts);
+    for (auto& L : labels) {
+        obj["tracks"].push_back({
+            {"id", L.track_id},
+            {"x",  L.det.x},
+            {"y",  L.det.y},
+            {"w",  L.det.w},
+            {"h",  L.det.h}
+        });
+    }
+
+    buf_ = obj.dump(layout_ == Layout::Pretty ? 2 : -1);
+    emit();
+}
+
+void JsonFrameWriter::write_dets(double ts, const Detection* dets, std::size_t n,
+                                 std::uint32_t stream)
+{
+    nlohmann::ordered_json obj;
+    if (streams_) obj["stream"] = stream;
+    obj["timestamp"]  = stamp(ts);
+    obj["detections"] = nlohmann::ordered_json::array();
+    for (std::size_t i=0; i<n; ++i)
+        obj["detections"].push_back({
+            {"x", dets[i].x}, {"y", dets[i].y}, {"w", dets[i].w}, {"h", dets[i].h}
+        });
+
+    buf_ = obj.dump(layout_ == Layout::Pretty ? 2 : -1);
+    emit();
+}
+
+std::string_view JsonFrameWriter::stamp(double ts)
+{
+    return {ts_buf_, std::size_t(clock_(iso::to_us(ts), ts_buf_) - ts_buf_)};
+}
+
+void JsonFrameWriter::emit()
+{
+    if (layout_ == Layout::Lines) {
+        buf_.push_back('\n');
+        out_.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+        out_.flush();
+        return;
+    }
+    if (layout_ == Layout::Minified) {
+        out_ << (count_++ ? ',' : '[');
+        out_.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+        out_.flush();
+        return;
+    }
+    // one level of array indentation in front of every line
+    out_ << (count_++ ? ",\n  " : "[\n  ");
+    std::size_t from = 0, nl;
+    while ((nl = buf_.find('\n', from)) != std::string::npos) {
+        out_.write(buf_.data() + from, nl + 1 - from);
+        out_ << "  ";
+        from = nl + 1;
+    }
+    out_.write(buf_.data() + from, buf_.size() - from);
+    out_.flush();
+}
+
+void JsonFrameWriter::finish()
+{
+    if (layout_ == Layout::Lines) { out_.flush(); return; }
+    if (layout_ == Layout::Minified) out_ << (count_ ? "]" : "[]");
+    else                             out_ << (count_ ? "\n]" : "[]");
+    out_.flush();
+}
@@ -0,0 +1,344 @@
+#include "LiveServer.hpp"
+#include "FrameIO.hpp"
+#include "BinaryFormat.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+[[noreturn]] void sys_fail(const std::string& what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+/**
+ * streambuf over a file descriptor.  underflow() hands out whatever one
+ * read() returns, so a reader never waits for more bytes than the current
+ * frame needs; output goes out on every flush.  Sockets are written with
+ * MSG_NOSIGNAL, so a vanished peer is an error, not SIGPIPE.  consumed()
+ * and pending() count the input bytes read so far and those already
+ * received but not yet read (buffered here or in the kernel).
+ */
+class FdBuf : public std::streambuf
+{
+public:
+    FdBuf(int in, int out, bool socket) : in_(in), out_(out), socket_(socket)
+    {
+        setg(ibuf_, ibuf_, ibuf_);
+        setp(obuf_, obuf_ + sizeof obuf_);
+    }
+
+    std::uint64_t consumed() const { return read_ - std::uint64_t(egptr() - gptr()); }
+
+    std::uint64_t pending() const
+    {
+        int n = 0;
+        if (::ioctl(in_, FIONREAD, &n) < 0) n = 0;
+        return std::uint64_t(egptr() - gptr()) + std::uint64_t(n > 0 ? n : 0);
+    }
+
+protected:
+    int_type underflow() override
+    {
+        ssize_t n;
+        do n = ::read(in_, ibuf_, sizeof ibuf_); while (n < 0 && errno == EINTR);
+        if (n < 0) sys_fail("live: read");
+        if (n == 0) return traits_type::eof();
+        read_ += std::uint64_t(n);
+        setg(ibuf_, ibuf_, ibuf_ + n);
+        return traits_type::to_int_type(*gptr());
+    }
+
+    int_type overflow(int_type c) override
+    {
+        drain();
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        if (n > epptr() - pptr()) { drain(); if (n >= std::streamsize(sizeof obuf_)) { put(s, n); return n; } }
+        std::memcpy(pptr(), s, std::size_t(n));
+        pbump(int(n));
+        return n;
+    }
+
+    int sync() override { drain(); return 0; }
+
+private:
+    void drain() { put(pbase(), pptr() - pbase()); setp(obuf_, obuf_ + sizeof obuf_); }
+
+    void put(const char* p, std::streamsize n)
+    {
+        while (n > 0) {
+            const ssize_t k = socket_ ? ::send(out_, p, std::size_t(n), MSG_NOSIGNAL)
+                                      : ::write(out_, p, std::size_t(n));
+            if (k < 0) { if (errno == EINTR) continue; sys_fail("live: write"); }
+            p += k; n -= k;
+        }
+    }
+
+    int  in_, out_;
+    bool socket_;
+    std::uint64_t read_ = 0;
+    char ibuf_[1 << 16];
+    char obuf_[1 << 16];
+};
+
+std::unique_ptr<LabelSink> make_sink(std::ostream& out, const std::string& format)
+{
+    if (format == "jsonl")  return std::make_unique<JsonFrameWriter>(out, false, JsonFrameWriter::Layout::Lines);
+    if (format == "json")   return std::make_unique<JsonFrameWriter>(out);
+    if (format == "binary" || format == "binary-f32")
+        return std::make_unique<BinaryLabelWriter>(out, format == "binary-f32");
+    throw std::invalid_argument("live: unknown reply format '" + format + "'");
+}
+
+std::uint64_t ns(metrics::Clock::duration d)
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+}
+
+} // namespace
+
+LiveOptions LiveOptions::from(const Config& cfg)
+{
+    LiveOptions o;
+    cfg.read("live", "listen",    o.listen);
+    cfg.read("live", "budget-ms", o.budget_ms);
+    cfg.read("live", "format",    o.format);
+    cfg.read("live", "partial-queue", o.overload.partial_queue);
+    cfg.read("live", "coast-queue",   o.overload.coast_queue);
+    cfg.read("live", "partial-ms",    o.overload.partial_ms);
+    cfg.read("live", "coast-ms",      o.overload.coast_ms);
+    cfg.read("live", "max-degraded",  o.overload.max_degraded);
+    return o;
+}
+
+struct LiveServer::Session
+{
+    int               fd = -1;
+    std::thread       thread;
+    std::atomic<bool> finished{false};
+    metrics::Registry snapshot;             // last published, under mu_
+};
+
+LiveServer::LiveServer(const Tracker& prototype, const LiveOptions& opt)
+    : prototype_(prototype), opt_(opt)
+{
+    if (opt_.format != "jsonl" && opt_.format != "json" && opt_.format != "binary" && opt_.format != "binary-f32")
+        throw std::invalid_argument("live: unknown reply format '" + opt_.format + "'");
+    if (opt_.budget_ms < 0) throw std::invalid_argument("live: negative latency budget");
+    if (opt_.overload.partial_ms < 0 || opt_.overload.coast_ms < 0)
+        throw std::invalid_argument("live: negative overload latency");
+    if (opt_.listen != "stdio") listen_socket();
+}
+
+LiveServer::~LiveServer()
+{
+    if (listen_fd_ >= 0) ::shutdown(listen_fd_, SHUT_RDWR);
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        for (auto& s : sessions_) if (s->fd >= 0) ::shutdown(s->fd, SHUT_RDWR);
+    }
+    reap(true);
+    if (listen_fd_ >= 0) ::close(listen_fd_);
+    if (!unix_path_.empty()) ::unlink(unix_path_.c_str());
+}
+
+void LiveServer::listen_socket()
+{
+    const std::string& ep = opt_.listen;
+    if (ep.rfind("unix:", 0) == 0) {
+        sockaddr_un addr{};
+        const std::string path = ep.substr(5);
+        if (path.empty() || path.size() >= sizeof addr.sun_path)
+            throw std::invalid_argument("live: bad socket path '" + path + "'");
+        // a socket left behind by an earlier run is replaced; other files are not
+        struct stat st;
+        if (::stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) ::unlink(path.c_str());
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) sys_fail("live: socket");
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof addr) < 0)
+            sys_fail("live: bind " + path);
+        unix_path_ = path;
+    }
+    else if (ep.rfind("tcp:", 0) == 0) {
+        const std::string hp = ep.substr(4);
+        const auto colon = hp.rfind(':');
+        const std::string host = colon == std::string::npos ? "" : hp.substr(0, colon);
+        const std::string port = colon == std::string::npos ? hp : hp.substr(colon + 1);
+        addrinfo hints{}, *res = nullptr;
+        hints.ai_family   = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags    = AI_PASSIVE;
+        if (const int rc = ::getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &res))
+            throw std::runtime_error("live: " + hp + ": " + ::gai_strerror(rc));
+        std::unique_ptr<addrinfo, void(*)(addrinfo*)> guard(res, ::freeaddrinfo);
+        listen_fd_ = ::socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+        if (listen_fd_ < 0) sys_fail("live: socket");
+        const int one = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+        if (::bind(listen_fd_, res->ai_addr, res->ai_addrlen) < 0) sys_fail("live: bind " + hp);
+    }
+    else throw std::invalid_argument("live: endpoint must be stdio, unix:PATH or tcp:[HOST:]PORT, not '" + ep + "'");
+
+    if (::listen(listen_fd_, 16) < 0) sys_fail("live: listen");
+}
+
+std::size_t LiveServer::run()
+{
+    if (listen_fd_ < 0) {
+        Session* sp;
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            sessions_.push_back(std::make_unique<Session>());
+            sp = sessions_.back().get();
+        }
+        return serve(STDIN_FILENO, STDOUT_FILENO, false, sp);
+    }
+
+    std::cerr << "live: listening on " << opt_.listen << "\n";
+    for (;;) {
+        const int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;                                          // shut down
+        }
+        if (unix_path_.empty()) {                           // replies are small: no Nagle delay
+            const int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+        }
+
+        reap(false);
+        auto s = std::make_unique<Session>();
+        Session* sp = s.get();
+        sp->fd = fd;
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            sessions_.push_back(std::move(s));
+        }
+        sp->thread = std::thread([this, sp] {
+            try { serve(sp->fd, sp->fd, true, sp); }
+            catch (const std::exception& e) { std::cerr << "live: connection closed: " << e.what() << "\n"; }
+            sp->finished = true;
+        });
+    }
+    reap(true);
+    std::lock_guard<std::mutex> lk(mu_);
+    return std::size_t(done_.counter[metrics::Frames]);
+}
+
+std::size_t LiveServer::serve(int in_fd, int out_fd, bool socket, Session* s)
+{
+    FdBuf        buf(in_fd, out_fd, socket);
+    std::istream in(&buf);
+    std::ostream out(&buf);
+    out.exceptions(std::ios::badbit);
+
+    Tracker           tracker = prototype_;
+    metrics::Registry io;
+    JsonFrameReader   reader(in);
+    auto              sink = make_sink(out, opt_.format);
+    const auto        budget = std::chrono::nanoseconds(std::int64_t(opt_.budget_ms * 1e6));
+    OverloadPolicy    overload(opt_.overload);
+    const bool        shed = opt_.overload.enabled();
+
+    auto snapshot = [&] {
+        metrics::Registry r = tracker.metrics();
+        r.merge(io);
+        return r;
+    };
+
+    Frame       fr;
+    std::size_t n = 0;
+    try {
+        for (;;) {
+            if (!reader.next(fr)) break;                    // blocks until a frame is in
+            const auto t0 = metrics::Clock::now();
+            StepMode mode = StepMode::Full;
+            if (shed) {
+                // frames waiting behind this one, at this connection's mean frame size
+                const std::uint64_t used = buf.consumed();
+                mode = overload.next(used ? std::size_t(buf.pending() * (n + 1) / used) : 0);
+            }
+            const auto& labels = tracker.step(fr.ts, fr.dets.data(), fr.dets.size(), mode);
+            {
+                metrics::Scoped t(io, metrics::Write);
+                sink->write(fr.ts, labels);
+                out.flush();
+            }
+            const auto dt = metrics::Clock::now() - t0;
+            if constexpr (metrics::enabled) io.stage[metrics::Latency].record(ns(dt));
+            if (budget.count() && dt > budget) io.add(metrics::MissedBudget, 1);
+            if (shed) overload.record(mode, std::chrono::duration<double, std::milli>(dt).count());
+
+            ++n;
+            if (opt_.report_every && n % opt_.report_every == 0) publish(s, snapshot(), false);
+        }
+        sink->finish();
+    }
+    catch (...) {
+        publish(s, snapshot(), true);
+        throw;
+    }
+    publish(s, snapshot(), true);
+    return n;
+}
+
+void LiveServer::publish(Session* s, const metrics::Registry& r, bool last)
+{
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        if (last) { done_.merge(r); s->snapshot = metrics::Registry{}; }
+        else      s->snapshot = r;
+    }
+    if (!opt_.report) return;
+    std::lock_guard<std::mutex> lk(report_mu_);
+    opt_.report(metrics());
+}
+
+metrics::Registry LiveServer::metrics() const
+{
+    std::lock_guard<std::mutex> lk(mu_);
+    metrics::Registry r = done_;
+    for (const auto& s : sessions_) r.merge(s->snapshot);
+    return r;
+}
+
+void LiveServer::reap(bool all)
+{
+    std::list<std::unique_ptr<Session>> gone;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        for (auto it = sessions_.begin(); it != sessions_.end(); ) {
+            if (all || (*it)->finished) { gone.push_back(std::move(*it)); it = sessions_.erase(it); }
+            else ++it;
+        }
+    }
+    for (auto& s : gone) {
+        if (s->thread.joinable()) s->thread.join();
+        if (s->fd >= 0) ::close(s->fd);
+    }
+}
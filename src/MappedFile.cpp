@@ -0,0 +1,43 @@
+#include "MappedFile.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        const int err = errno; ::close(fd);
+        throw std::runtime_error("cannot stat " + path + ": " + std::strerror(err));
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+
+    if (size_ > 0) {
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            const int err = errno; ::close(fd);
+            throw std::runtime_error("cannot mmap " + path + ": " + std::strerror(err));
+        }
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(p);
+    }
+    ::close(fd);                       // the mapping keeps the file alive
+}
+
+MappedFile::MappedFile(MappedFile&& o) noexcept : data_(o.data_), size_(o.size_)
+{
+    o.data_ = nullptr; o.size_ = 0;
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+}
@@ -0,0 +1,147 @@
+#include "FrameIO.hpp"
+#include "iso_time.hpp"
+#include <charconv>
+#include <stdexcept>
+
+MappedJsonFrameReader::MappedJsonFrameReader(const std::string& path)
+    : file_(path), p_(file_.data()), end_(file_.data() + file_.size())
+{
+    skip_ws();
+    if (p_ < end_ && *p_ == '[') ++p_;
+}
+
+void MappedJsonFrameReader::fail(const char* what) const
+{
+    throw std::runtime_error(std::string("JSON input: ") + what + " at byte " +
+                             std::to_string(p_ - file_.data()));
+}
+
+void MappedJsonFrameReader::skip_ws()
+{
+    while (p_ < end_ && (*p_==' ' || *p_=='\n' || *p_=='\r' || *p_=='\t')) ++p_;
+}
+
+void MappedJsonFrameReader::expect(char c)
+{
+    skip_ws();
+    if (p_ >= end_ || *p_ != c) fail("unexpected character");
+    ++p_;
+}
+
+std::string_view MappedJsonFrameReader::string()
+{
+    expect('"');
+    const char* b = p_;
+    while (p_ < end_ && *p_ != '"') p_ += (*p_ == '\\') ? 2 : 1;
+    if (p_ >= end_) fail("unterminated string");
+    return {b, static_cast<std::size_t>(p_++ - b)};
+}
+
+double MappedJsonFrameReader::number()
+{
+    skip_ws();
+    double v = 0.0;
+    const auto r = std::from_chars(p_, end_, v);
+    if (r.ec != std::errc()) fail("bad number");
+    p_ = r.ptr;
+    return v;
+}
+
+void MappedJsonFrameReader::skip_value()
+{
+    skip_ws();
+    if (p_ >= end_) fail("unexpected end");
+    if (*p_ == '"') { string(); return; }
+    if (*p_ == '{' || *p_ == '[') {
+        int depth = 0;
+        do {
+            if      (*p_ == '"')                { string(); continue; }
+            else if (*p_ == '{' || *p_ == '[')  ++depth;
+            else if (*p_ == '}' || *p_ == ']')  --depth;
+            ++p_;
+        } while (depth > 0 && p_ < end_);
+        return;
+    }
+    while (p_ < end_ && *p_!=',' && *p_!='}' && *p_!=']' &&
+           *p_!=' ' && *p_!='\n' && *p_!='\r' && *p_!='\t') ++p_;   // number / literal
+}
+
+void MappedJsonFrameReader::detection(Detection& d)
+{
+    expect('{');
+    skip_ws();
+    if (p_ < end_ && *p_ == '}') { ++p_; return; }
+    for (;;) {
+        const std::string_view k = string();
+        expect(':');
+        if (k.size() == 1) {
+            switch (k[0]) {
+                case 'x': d.x = number(); break;
+                case 'y': d.y = number(); break;
+                case 'w': d.w = number(); break;
+                case 'h': d.h = number(); break;
+                default:  skip_value();
+            }
+        }
+        else skip_value();
+
+        skip_ws();
+        if (p_ < end_ && *p_ == ',') { ++p_; continue; }
+        expect('}');
+        return;
+    }
+}
+
+bool MappedJsonFrameReader::next(Frame& fr)
+{
+    // between frames: skip separators up to the next object
+    for (;;) {
+        skip_ws();
+        if (p_ >= end_ || *p_ == ']') return false;
+        if (*p_ == ',') { ++p_; continue; }
+        break;
+    }
+
+    fr.dets.clear();
+    fr.stream = 0;
+    bool have_ts = false;
+    expect('{');
+    skip_ws();
+    if (p_ < end_ && *p_ == '}') fail("frame without timestamp");
+    for (;;) {
+        const std::string_view k = string();
+        expect(':');
+        if (k == "timestamp") {
+            const std::string_view v = string();
+            if (!iso::decode(v.data(), v.data() + v.size(), fr.ts)) fail("bad timestamp");
+            have_ts = true;
+        }
+        else if (k == "stream") {
+            const double v = number();
+            if (!(v >= 0.0 && v <= 4294967295.0) || v != static_cast<std::uint32_t>(v))
+                fail("stream id must be an unsigned integer");
+            fr.stream = static_cast<std::uint32_t>(v);
+        }
+        else if (k == "detections") {
+            expect('[');
+            skip_ws();
+            if (p_ < end_ && *p_ == ']') ++p_;
+            else for (;;) {
+                fr.dets.push_back({0.0, 0.0, 0.0, 0.0});
+                detection(fr.dets.back());
+                skip_ws();
+                if (p_ < end_ && *p_ == ',') { ++p_; continue; }
+                expect(']');
+                break;
+            }
+        }
+        else skip_value();
+
+        skip_ws();
+        if (p_ < end_ && *p_ == ',') { ++p_; continue; }
+        expect('}');
+        break;
+    }
+    if (!have_ts) fail("frame without timestamp");
+    return true;
+}
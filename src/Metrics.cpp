@@ -0,0 +1,130 @@
+#include "Metrics.hpp"
+#include <nlohmann/json.hpp>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace metrics {
+
+const char* stage_name(Stage s)
+{
+    static const char* const names[kStages] = {
+        "predict", "gate", "assign", "correct", "spawn", "labels", "cull", "step",
+        "parse", "write", "vis", "latency", "transfer", "kernel"
+    };
+    return names[s];
+}
+
+const char* counter_name(Counter c)
+{
+    static const char* const names[kCounters] = {
+        "frames", "detections", "matches", "spawned", "culled",
+        "candidates", "assign_cells", "allocations",
+        "warm_seeded", "fast_path", "parallel_gates", "missed_budget", "stitched",
+        "evicted", "refused", "batched_steps", "coasted", "partial"
+    };
+    return names[c];
+}
+
+// ───────────────── histogram ────────────────────────────────────────
+void Histogram::merge(const Histogram& o)
+{
+    for (int i=0; i<size; ++i) bins_[i] += o.bins_[i];
+    count_ += o.count_; sum_ += o.sum_;
+    if (o.max_ > max_) max_ = o.max_;
+}
+
+double Histogram::lower(int i)
+{
+    if (i < sub) return i;
+    const int msb = i / sub + 2;
+    return std::ldexp(double(sub + i % sub), msb - 3);
+}
+
+double Histogram::quantile(double q) const
+{
+    if (count_ == 0) return 0.0;
+    const double rank = q * double(count_);
+    std::uint64_t seen = 0;
+    for (int i=0; i<size; ++i) {
+        seen += bins_[i];
+        if (bins_[i] && double(seen) >= rank) {
+            const double mid = 0.5 * (lower(i) + lower(i + 1));   // bucket centre
+            return mid < double(max_) ? mid : double(max_);
+        }
+    }
+    return double(max_);
+}
+
+void Registry::merge(const Registry& o)
+{
+    for (int s=0; s<kStages; ++s)   stage[s].merge(o.stage[s]);
+    for (int c=0; c<kCounters; ++c) counter[c] += o.counter[c];
+    tracks_alive += o.tracks_alive;
+}
+
+// ───────────────── exporters ────────────────────────────────────────
+std::string to_json(const Registry& r)
+{
+    nlohmann::ordered_json j;
+    j["enabled"] = enabled;
+    auto& st = j["stages"] = nlohmann::ordered_json::object();
+    for (int s=0; s<kStages; ++s) {
+        const Histogram& h = r.stage[s];
+        if (!h.count()) continue;
+        st[stage_name(Stage(s))] = {
+            {"count",  h.count()},
+            {"sum_us", h.sum() * 1e-3},
+            {"p50_us", h.quantile(0.50) * 1e-3},
+            {"p90_us", h.quantile(0.90) * 1e-3},
+            {"p99_us", h.quantile(0.99) * 1e-3},
+            {"max_us", h.max() * 1e-3}
+        };
+    }
+    auto& ct = j["counters"] = nlohmann::ordered_json::object();
+    for (int c=0; c<kCounters; ++c) ct[counter_name(Counter(c))] = r.counter[c];
+    j["gauges"] = {{"tracks_alive", r.tracks_alive}};
+    return j.dump(2) + "\n";
+}
+
+std::string to_prometheus(const Registry& r)
+{
+    std::ostringstream o;
+    o.precision(9);
+    o << "# HELP tracker_stage_seconds Latency of tracker and I/O stages.\n"
+         "# TYPE tracker_stage_seconds summary\n";
+    for (int s=0; s<kStages; ++s) {
+        const Histogram& h = r.stage[s];
+        if (!h.count()) continue;
+        const char* n = stage_name(Stage(s));
+        for (double q : {0.5, 0.9, 0.99})
+            o << "tracker_stage_seconds{stage=\"" << n << "\",quantile=\"" << q << "\"} "
+              << h.quantile(q) * 1e-9 << "\n";
+        o << "tracker_stage_seconds_sum{stage=\""   << n << "\"} " << h.sum() * 1e-9 << "\n"
+          << "tracker_stage_seconds_count{stage=\"" << n << "\"} " << h.count() << "\n";
+    }
+    for (int c=0; c<kCounters; ++c) {
+        const char* n = counter_name(Counter(c));
+        o << "# TYPE tracker_" << n << "_total counter\n"
+          << "tracker_" << n << "_total " << r.counter[c] << "\n";
+    }
+    o << "# TYPE tracker_tracks_alive gauge\n"
+      << "tracker_tracks_alive " << r.tracks_alive << "\n";
+    return o.str();
+}
+
+void write_file(const std::string& path, const std::string& format, const Registry& r)
+{
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary);
+        if (!f) throw std::runtime_error("cannot write metrics to " + tmp);
+        f << (format == "prometheus" ? to_prometheus(r) : to_json(r));
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+        throw std::runtime_error("cannot replace metrics file " + path);
+}
+
+} // namespace metrics
@@ -0,0 +1,260 @@
+#include "MultiStream.hpp"
+#include <algorithm>
+
+namespace {
+constexpr int batch = 16;       // frames a worker steps before yielding a stream
+}
+
+MultiStreamOptions MultiStreamOptions::from(const Config& cfg)
+{
+    MultiStreamOptions o;
+    cfg.read("pipeline", "workers", o.workers);
+    cfg.read("pipeline", "window",  o.window);
+    cfg.read("pipeline", "batch-streams", o.batch_streams);
+    cfg.read("pipeline", "backend", o.backend);
+    return o;
+}
+
+MultiStreamEngine::MultiStreamEngine(const Tracker& prototype, const MultiStreamOptions& opt)
+    : prototype_(prototype), opt_(opt) {}
+
+// ───────────────── reader (calling thread) ──────────────────────────
+std::size_t MultiStreamEngine::run(FrameSource& src, LabelSink& sink)
+{
+    const unsigned nw = opt_.workers ? opt_.workers
+                                     : std::max(1u, std::thread::hardware_concurrency());
+    ring_.resize(std::max<std::size_t>(1, opt_.window));
+    for (unsigned i=0; i<nw; ++i) workers_.push_back(std::make_unique<Worker>());
+    if (opt_.batch_streams > 1) {
+        const std::string backend = resolve_backend(opt_.backend);
+        for (auto& w : workers_) w->backend = make_backend(backend);
+    }
+    for (unsigned i=0; i<nw; ++i) threads_.emplace_back(&MultiStreamEngine::worker, this, i);
+    std::thread out(&MultiStreamEngine::writer, this, std::ref(sink));
+
+    try {
+        for (;;) {
+            Job* job;
+            {
+                std::unique_lock<std::mutex> lk(out_m_);
+                free_cv_.wait(lk, [&]{ return error_ || read_seq_ - write_seq_ < ring_.size(); });
+                if (error_) break;
+                job = &ring_[read_seq_ % ring_.size()];
+            }
+            {
+                metrics::Scoped t(read_m_, metrics::Parse);
+                if (!src.next(job->frame)) break;
+            }
+            {
+                std::lock_guard<std::mutex> lk(out_m_);
+                ++read_seq_;
+            }
+
+            auto& s = streams_[job->frame.stream];
+            if (!s) s = std::make_unique<Stream>(prototype_, job->frame.stream % nw);
+            {
+                std::lock_guard<std::mutex> lk(s->m);
+                s->pending.push_back(job);
+                if (s->scheduled) continue;      // its worker will get to it
+                s->scheduled = true;
+            }
+            schedule(s.get());
+        }
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lk(out_m_);
+        if (!error_) error_ = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(out_m_);
+        input_done_ = true;
+    }
+    done_cv_.notify_all();
+    out.join();
+    {
+        std::lock_guard<std::mutex> lk(idle_m_);
+        stop_ = true;
+    }
+    idle_cv_.notify_all();
+    for (auto& t : threads_) t.join();
+    threads_.clear();
+
+    if (error_) std::rethrow_exception(error_);
+    return read_seq_;
+}
+
+metrics::Registry MultiStreamEngine::metrics() const
+{
+    metrics::Registry r = read_m_;
+    r.merge(write_m_);
+    for (const auto& [id, s] : streams_) r.merge(s->tracker.metrics());
+    for (const auto& w : workers_) r.merge(w->metrics);
+    return r;
+}
+
+// ───────────────── scheduling ───────────────────────────────────────
+void MultiStreamEngine::schedule(Stream* s)
+{
+    {
+        std::lock_guard<std::mutex> lk(workers_[s->home]->m);
+        workers_[s->home]->runnable.push_back(s);
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+    { std::lock_guard<std::mutex> lk(idle_m_); }   // no lost wake-up
+    idle_cv_.notify_one();
+}
+
+MultiStreamEngine::Stream* MultiStreamEngine::take(unsigned self)
+{
+    const unsigned nw = static_cast<unsigned>(workers_.size());
+    for (unsigned k=0; k<nw; ++k) {
+        Worker& w = *workers_[(self + k) % nw];
+        std::lock_guard<std::mutex> lk(w.m);
+        if (w.runnable.empty()) continue;
+        Stream* s;
+        if (k == 0) { s = w.runnable.front(); w.runnable.pop_front(); }   // own: oldest first
+        else        { s = w.runnable.back();  w.runnable.pop_back();  }   // steal: newest
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return s;
+    }
+    return nullptr;
+}
+
+void MultiStreamEngine::worker(unsigned self)
+{
+    for (;;) {
+        if (Stream* s = take(self)) {
+            if (opt_.batch_streams > 1) drain_batch(s, self);
+            else                        drain(s, self);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lk(idle_m_);
+        idle_cv_.wait(lk, [&]{ return stop_ || queued_.load(std::memory_order_acquire) > 0; });
+        if (stop_ && queued_.load(std::memory_order_acquire) == 0) return;
+    }
+}
+
+void MultiStreamEngine::drain(Stream* s, unsigned self)
+{
+    for (int done=0;; ++done) {
+        Job* job;
+        {
+            std::lock_guard<std::mutex> lk(s->m);
+            if (s->pending.empty()) { s->scheduled = false; return; }
+            if (done == batch) break;            // let other streams run
+            job = s->pending.front();
+            s->pending.pop_front();
+        }
+
+        try {
+            job->labels = s->tracker.step(job->frame.ts, job->frame.dets.data(),
+                                          job->frame.dets.size());
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lk(out_m_);
+            if (!error_) error_ = std::current_exception();
+            job->labels.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lk(out_m_);
+            job->done = true;
+        }
+        done_cv_.notify_one();
+    }
+
+    // still pending and still marked scheduled: requeue behind the others
+    s->home = self;
+    schedule(s);
+}
+
+void MultiStreamEngine::drain_batch(Stream* first, unsigned self)
+{
+    Worker& w = *workers_[self];
+    w.group.assign(1, first);
+    while (w.group.size() < opt_.batch_streams) {
+        Stream* s = take(self);
+        if (!s) break;
+        w.group.push_back(s);
+    }
+
+    for (int round=0; !w.group.empty(); ++round) {
+        // one frame from each stream that still has one
+        w.jobs.clear(); w.trackers.clear();
+        std::size_t kept = 0;
+        for (Stream* s : w.group) {
+            std::lock_guard<std::mutex> lk(s->m);
+            if (s->pending.empty()) { s->scheduled = false; continue; }
+            w.group[kept++] = s;
+            if (round == batch) continue;        // let other streams run
+            w.jobs.push_back(s->pending.front());
+            s->pending.pop_front();
+            w.trackers.push_back(&s->tracker);
+        }
+        w.group.resize(kept);
+        if (round == batch || w.jobs.empty()) break;
+
+        const std::size_t n = w.jobs.size();
+        try {
+            for (std::size_t k=0; k<n; ++k)
+                w.trackers[k]->begin(w.jobs[k]->frame.ts, w.jobs[k]->frame.dets.data(),
+                                     w.jobs[k]->frame.dets.size());
+            step_batch(*w.backend, w.trackers.data(), n, w.metrics);
+            for (std::size_t k=0; k<n; ++k) {
+                std::vector<Label>& labels = w.jobs[k]->labels;
+                labels.resize(w.jobs[k]->frame.dets.size());
+                labels.resize(w.trackers[k]->finish(labels.data()));
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lk(out_m_);
+            if (!error_) error_ = std::current_exception();
+            for (Job* job : w.jobs) job->labels.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lk(out_m_);
+            for (Job* job : w.jobs) job->done = true;
+        }
+        done_cv_.notify_one();
+    }
+
+    // still pending and still marked scheduled: requeue behind the others
+    for (Stream* s : w.group) { s->home = self; schedule(s); }
+}
+
+// ───────────────── writer ───────────────────────────────────────────
+void MultiStreamEngine::writer(LabelSink& sink)
+{
+    const std::size_t W = ring_.size();
+    for (;;) {
+        Job* job;
+        {
+            std::unique_lock<std::mutex> lk(out_m_);
+            done_cv_.wait(lk, [&]{
+                return error_ || (write_seq_ < read_seq_ && ring_[write_seq_ % W].done)
+                              || (input_done_ && write_seq_ == read_seq_);
+            });
+            if (error_ || write_seq_ == read_seq_) break;
+            job = &ring_[write_seq_ % W];
+        }
+
+        try {
+            metrics::Scoped t(write_m_, metrics::Write);
+            sink.write_stream(job->frame.stream, job->frame.ts, job->labels);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lk(out_m_);
+            if (!error_) error_ = std::current_exception();
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lk(out_m_);
+            job->done = false;
+            ++write_seq_;
+        }
+        free_cv_.notify_one();
+    }
+    free_cv_.notify_one();                       // unblock the reader on error
+}
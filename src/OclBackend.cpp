@@ -0,0 +1,267 @@
+// OclBackend.cpp - BatchBackend on an OpenCL device through OpenCV's T-API.
+#include "BatchBackend.hpp"
+#include "kalman.hpp"
+#include <opencv2/core.hpp>
+#include <opencv2/core/ocl.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+using R = tracker_real;
+constexpr bool real_is_double = std::is_same_v<R, double>;
+constexpr int  cv_real = real_is_double ? CV_64F : CV_32F;
+
+// Device layout: one row per buffer, columns of n tracks side by side.
+//   state  20 n : for axis k (x y w h), p v P00 P01 P11 at (5k + f) n + i
+//   dt     n    : per-track dt, clamped like TrackStore::predict
+//   dets   4 D  : x y w h of every tracker's detections, back to back
+//   meta   3 D  : first track, #tracks and first pair slot of each detection
+//   cost, iou   : one slot per (detection, track) pair of the same tracker,
+//                 detection-major; iou < 0 marks a pair the gate dropped
+//   z      5 n  : measured x y w h, then the mask (1: matched)
+const char* const source = R"CLC(
+#ifdef REAL_IS_DOUBLE
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#endif
+
+__kernel void kf_predict(__global real* st, __global const real* dtv, int n, real pn)
+{
+    const int i = get_global_id(0);
+    if (i >= n) return;
+    const real dt = dtv[i], dt2 = dt*dt, dt3 = dt2*dt, dt4 = dt2*dt2;
+    const real q00 = dt4*(real)0.25*pn, q01 = dt3*(real)0.5*pn, q11 = dt2*pn;
+    for (int k=0; k<4; ++k) {
+        __global real* a = st + 5*k*n;
+        const real t00 = a[2*n+i] + dt*a[3*n+i],
+                   t01 = a[3*n+i] + dt*a[4*n+i];
+        a[i]     += dt*a[n+i];
+        a[2*n+i]  = t00 + dt*t01 + q00;
+        a[3*n+i]  = t01 + q01;
+        a[4*n+i] += q11;
+    }
+}
+
+__kernel void gate_pairs(__global const real* st, int n, __global const real* det,
+                         __global const int* meta, int nd,
+                         __global real* cost, __global real* iou,
+                         real max_dist, real min_iou, real alpha)
+{
+    const int g = get_global_id(0);
+    if (g >= nd) return;
+    const int t0 = meta[3*g], nt = meta[3*g+1], base = meta[3*g+2];
+    const real dx = det[4*g], dy = det[4*g+1], dw = det[4*g+2], dh = det[4*g+3];
+    const real cx = dx + dw*(real)0.5, cy = dy + dh*(real)0.5;
+    for (int k=0; k<nt; ++k) {
+        const int i = t0 + k;
+        const real rx = st[i], ry = st[5*n+i], rw = st[10*n+i], rh = st[15*n+i];
+        const real dist = hypot(cx - (rx + rw*(real)0.5), cy - (ry + rh*(real)0.5));
+        const real w  = fmax((real)0, fmin(rx+rw, dx+dw) - fmax(rx,dx)),
+                   h  = fmax((real)0, fmin(ry+rh, dy+dh) - fmax(ry,dy));
+        const real inter = w*h, uni = rw*rh + dw*dh - inter;
+        const real v = uni > (real)0 ? inter/uni : (real)0;
+        const bool keep = !(dist > max_dist) && !(v < min_iou);
+        cost[base+k] = alpha*((real)1 - v) + ((real)1 - alpha)*dist;
+        iou[base+k]  = keep ? v : (real)-1;
+    }
+}
+
+__kernel void kf_correct(__global real* st, __global const real* z, int n, real r)
+{
+    const int i = get_global_id(0);
+    if (i >= n || z[4*n+i] == (real)0) return;
+    for (int k=0; k<4; ++k) {
+        __global real* a = st + 5*k*n;
+        const real P00 = a[2*n+i], P01 = a[3*n+i];
+        const real S = P00 + r, K0 = P00/S, K1 = P01/S;
+        const real res = z[k*n+i] - a[i];
+        a[i]     += K0*res;
+        a[n+i]   += K1*res;
+        a[4*n+i] -= K1*P01;
+        a[3*n+i]  = P01 - K0*P01;
+        a[2*n+i]  = P00 - K0*P00;
+    }
+}
+)CLC";
+
+/** A one-row host staging buffer of `n` reals (reused while big enough). */
+R* row(cv::Mat& m, std::size_t n)
+{
+    m.create(1, static_cast<int>(std::max<std::size_t>(n, 1)), cv_real);
+    return m.ptr<R>();
+}
+
+bool run(cv::ocl::Kernel& k, std::size_t items)
+{
+    std::size_t g[1] = {items};
+    return k.run(1, g, nullptr, true);
+}
+
+class OclBackend final : public BatchBackend
+{
+public:
+    OclBackend()
+    {
+        const cv::ocl::ProgramSource src(source);
+        const std::string opts = real_is_double ? "-D real=double -D REAL_IS_DOUBLE" : "-D real=float";
+        predict_.create("kf_predict", src, opts);
+        gate_.create("gate_pairs", src, opts);
+        correct_.create("kf_correct", src, opts);
+        if (predict_.empty() || gate_.empty() || correct_.empty())
+            throw std::runtime_error("opencl backend: kernel build failed");
+    }
+
+    const char* name() const override { return "opencl"; }
+
+    void predict_gate(Tracker* const* t, std::size_t n, metrics::Registry& m) override
+    {
+        metrics::Lap lap(m);
+
+        // ─── pack every tracker's tracks and detections ───────────────
+        track0_.assign(1, 0);
+        std::size_t nd = 0, pairs = 0;
+        for (std::size_t j=0; j<n; ++j) {
+            const Tracker::View v = t[j]->view();
+            track0_.push_back(track0_.back() + v.tracks.size());
+            nd    += v.n;
+            pairs += v.n * v.tracks.size();
+        }
+        N_ = track0_.back();
+
+        R* st = row(state_, 20*N_);
+        R* dt = row(dt_, N_);
+        R* dv = row(dets_, 4*nd);
+        int* meta = row_int(meta_, 3*nd);
+        std::size_t g = 0, base = 0;
+        for (std::size_t j=0; j<n; ++j) {
+            const Tracker::View v = t[j]->view();
+            const std::size_t i0 = track0_[j], nt = v.tracks.size();
+            for (std::size_t i=0; i<nt; ++i) {
+                for (int k=0; k<4; ++k) {
+                    const auto& a = v.tracks.ax[k];
+                    R* c = st + 5*k*N_ + i0 + i;
+                    c[0] = a.p[i]; c[N_] = a.v[i]; c[2*N_] = a.P00[i]; c[3*N_] = a.P01[i]; c[4*N_] = a.P11[i];
+                }
+                const double d = v.ts - v.tracks.last_ts[i];
+                dt[i0 + i] = R(d > 0.0 ? d : 1e-6);
+            }
+            for (std::size_t d=0; d<v.n; ++d, ++g, base += nt) {
+                dv[4*g] = v.dets[d].x; dv[4*g+1] = v.dets[d].y; dv[4*g+2] = v.dets[d].w; dv[4*g+3] = v.dets[d].h;
+                meta[3*g] = int(i0); meta[3*g+1] = int(nt); meta[3*g+2] = int(base);
+            }
+        }
+        state_.copyTo(state_u_);
+        dt_.copyTo(dt_u_);
+        dets_.copyTo(dets_u_);
+        meta_.copyTo(meta_u_);
+        lap.mark(metrics::Transfer);
+
+        // ─── predict, then score every same-tracker pair ──────────────
+        const int in = static_cast<int>(N_), ind = static_cast<int>(nd);
+        const gate::Gate<R> gt = n ? t[0]->view().gate : gate::Gate<R>{};   // one config per group
+        cost_u_.create(1, static_cast<int>(std::max<std::size_t>(pairs, 1)), cv_real);
+        iou_u_.create(1, static_cast<int>(std::max<std::size_t>(pairs, 1)), cv_real);
+        using Arg = cv::ocl::KernelArg;
+        if (N_) {
+            predict_.args(Arg::PtrReadWrite(state_u_), Arg::PtrReadOnly(dt_u_), in, R(kf::proc_noise));
+            if (!run(predict_, N_)) throw std::runtime_error("opencl backend: predict launch failed");
+        }
+        if (pairs) {
+            gate_.args(Arg::PtrReadOnly(state_u_), in, Arg::PtrReadOnly(dets_u_), Arg::PtrReadOnly(meta_u_), ind,
+                       Arg::PtrWriteOnly(cost_u_), Arg::PtrWriteOnly(iou_u_), gt.max_dist, gt.min_iou, gt.alpha);
+            if (!run(gate_, nd)) throw std::runtime_error("opencl backend: gate launch failed");
+        }
+        lap.mark(metrics::Kernel);
+
+        // ─── candidate lists back on the host ─────────────────────────
+        cost_u_.copyTo(cost_);
+        iou_u_.copyTo(iou_);
+        const R* cost = cost_.ptr<R>();
+        const R* iou  = iou_.ptr<R>();
+        base = 0;
+        for (std::size_t j=0; j<n; ++j) {
+            Tracker::View v = t[j]->view();
+            const int nt = static_cast<int>(v.tracks.size());
+            for (int d=0; d<static_cast<int>(v.n); ++d, base += std::size_t(nt))
+                for (int i=0; i<nt; ++i) if (iou[base + std::size_t(i)] >= R(0)) {
+                    v.edges.push_back({i, d, cost[base + std::size_t(i)]});
+                    v.ious.push_back(iou[base + std::size_t(i)]);
+                }
+            v.tracks.age_all();
+        }
+        lap.mark(metrics::Transfer);
+    }
+
+    void correct(Tracker* const* t, std::size_t n, metrics::Registry& m) override
+    {
+        metrics::Lap lap(m);
+        R* z = row(z_, 5*N_);
+        for (std::size_t j=0; j<n; ++j) {
+            const Tracker::View v = t[j]->view();
+            for (std::size_t i=0, i0=track0_[j]; i<v.tracks.size(); ++i) {
+                const int d = v.tr2det[i];
+                const R box[4] = {d < 0 ? R(0) : v.dets[d].x, d < 0 ? R(0) : v.dets[d].y,
+                                  d < 0 ? R(0) : v.dets[d].w, d < 0 ? R(0) : v.dets[d].h};
+                for (int k=0; k<4; ++k) z[k*N_ + i0 + i] = box[k];
+                z[4*N_ + i0 + i] = d < 0 ? R(0) : R(1);
+            }
+        }
+        z_.copyTo(z_u_);
+        lap.mark(metrics::Transfer);
+
+        if (N_) {
+            using Arg = cv::ocl::KernelArg;
+            correct_.args(Arg::PtrReadWrite(state_u_), Arg::PtrReadOnly(z_u_), static_cast<int>(N_), R(kf::meas_noise));
+            if (!run(correct_, N_)) throw std::runtime_error("opencl backend: correct launch failed");
+        }
+        lap.mark(metrics::Kernel);
+
+        // ─── filter state back into each tracker's store ──────────────
+        state_u_.copyTo(state_);
+        const R* st = state_.ptr<R>();
+        for (std::size_t j=0; j<n; ++j) {
+            Tracker::View v = t[j]->view();
+            for (std::size_t i=0, i0=track0_[j]; i<v.tracks.size(); ++i)
+                for (int k=0; k<4; ++k) {
+                    auto& a = v.tracks.ax[k];
+                    const R* c = st + 5*k*N_ + i0 + i;
+                    a.p[i] = c[0]; a.v[i] = c[N_]; a.P00[i] = c[2*N_]; a.P01[i] = c[3*N_]; a.P11[i] = c[4*N_];
+                }
+            v.tracks.mark_updated(v.ts, v.tr2det.data());
+        }
+        lap.mark(metrics::Transfer);
+    }
+
+private:
+    static int* row_int(cv::Mat& m, std::size_t n)
+    {
+        m.create(1, static_cast<int>(std::max<std::size_t>(n, 1)), CV_32S);
+        return m.ptr<int>();
+    }
+
+    cv::ocl::Kernel predict_, gate_, correct_;
+    std::vector<std::size_t> track0_;       // first packed track of each tracker
+    std::size_t N_ = 0;                     // packed tracks this step
+    cv::Mat  state_, dt_, dets_, meta_, cost_, iou_, z_;
+    cv::UMat state_u_, dt_u_, dets_u_, meta_u_, cost_u_, iou_u_, z_u_;
+};
+
+} // namespace
+
+bool ocl_usable(std::string& why)
+{
+    if (!cv::ocl::haveOpenCL()) { why = "no OpenCL runtime"; return false; }
+    cv::ocl::setUseOpenCL(true);
+    const cv::ocl::Device& d = cv::ocl::Device::getDefault();
+    if (!d.available()) { why = "no OpenCL device"; return false; }
+    if (real_is_double && d.doubleFPConfig() == 0) {
+        why = d.name() + " has no fp64; build with TRACKER_FLOAT";
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<BatchBackend> make_ocl_backend() { return std::make_unique<OclBackend>(); }
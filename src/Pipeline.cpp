@@ -0,0 +1,121 @@
+#include "Pipeline.hpp"
+#include "VisPipeline.hpp"
+#include "spsc_ring.hpp"
+#include <atomic>
+#include <exception>
+#include <thread>
+
+namespace {
+struct LabelFrame { double ts; std::vector<Label> labels; };
+
+/** Vis submit plus the per-frame callback, on the tracker stage. */
+void after_step(const RunHooks& hooks, metrics::Registry& m, const Tracker& tracker,
+                std::size_t n)
+{
+    if (hooks.vis) {
+        metrics::Scoped t(m, metrics::Vis);
+        hooks.vis->submit(static_cast<int>(n), tracker.tracks());
+    }
+    if (hooks.on_frame) hooks.on_frame(n + 1);
+}
+} // namespace
+
+PipelineOptions PipelineOptions::from(const Config& cfg)
+{
+    PipelineOptions o;
+    cfg.read("pipeline", "frame-queue", o.frame_queue);
+    cfg.read("pipeline", "label-queue", o.label_queue);
+    return o;
+}
+
+std::size_t run_sequential(FrameSource& src, Tracker& tracker, LabelSink& sink,
+                           const RunHooks& hooks)
+{
+    metrics::Registry scratch;
+    metrics::Registry& m = hooks.io ? *hooks.io : scratch;
+
+    FrameView   frame;
+    std::size_t n = 0;
+    for (;;) {
+        {
+            metrics::Scoped t(m, metrics::Parse);
+            if (!src.next_view(frame)) break;
+        }
+        const auto& labels = tracker.step(frame.ts, frame.dets, frame.n);
+        {
+            metrics::Scoped t(m, metrics::Write);
+            sink.write(frame.ts, labels);
+        }
+        after_step(hooks, m, tracker, n++);
+    }
+    return n;
+}
+
+std::size_t run_pipelined(FrameSource& src, Tracker& tracker, LabelSink& sink,
+                          const RunHooks& hooks, const PipelineOptions& opt)
+{
+    metrics::Registry  parse_m, write_m, scratch;
+    metrics::Registry& track_m = hooks.io ? *hooks.io : scratch;
+    SpscRing<Frame>      frames(opt.frame_queue);
+    SpscRing<LabelFrame> out   (opt.label_queue);
+    std::atomic<bool>    abort{false};
+    std::exception_ptr   parse_err, write_err, track_err;
+
+    // ─── stage 1: parse ─────────────────────────────────────────────
+    std::thread parser([&] {
+        try {
+            while (!abort.load(std::memory_order_relaxed)) {
+                Frame* f = frames.try_producer_slot();
+                if (!f) { std::this_thread::yield(); continue; }
+                metrics::Scoped t(parse_m, metrics::Parse);
+                if (!src.next(*f)) break;
+                frames.push();
+            }
+        }
+        catch (...) { parse_err = std::current_exception(); }
+        frames.close();
+    });
+
+    // ─── stage 3: serialise ─────────────────────────────────────────
+    std::thread writer([&] {
+        while (LabelFrame* lf = out.front()) {
+            if (!write_err) {
+                try {
+                    metrics::Scoped t(write_m, metrics::Write);
+                    sink.write(lf->ts, lf->labels);
+                }
+                catch (...) { write_err = std::current_exception(); abort = true; }
+            }
+            out.pop();                        // keep draining so tracking never blocks
+        }
+    });
+
+    // ─── stage 2: track (this thread) ───────────────────────────────
+    std::size_t n = 0;
+    try {
+        while (Frame* f = frames.front()) {
+            if (abort.load(std::memory_order_relaxed)) { frames.pop(); continue; }
+            LabelFrame* lf = out.producer_slot();
+            lf->ts     = f->ts;
+            lf->labels = tracker.step(f->ts, f->dets.data(), f->dets.size());
+            frames.pop();
+            out.push();
+            after_step(hooks, track_m, tracker, n++);
+        }
+    }
+    catch (...) {
+        track_err = std::current_exception();
+        abort = true;
+        while (frames.front()) frames.pop();  // unblock the parser
+    }
+    out.close();
+    parser.join();
+    writer.join();
+    track_m.merge(parse_m);
+    track_m.merge(write_m);
+
+    if (parse_err) std::rethrow_exception(parse_err);
+    if (track_err) std::rethrow_exception(track_err);
+    if (write_err) std::rethrow_exception(write_err);
+    return n;
+}
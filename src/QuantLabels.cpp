@@ -0,0 +1,302 @@
+#include "QuantLabels.hpp"
+#include "iso_time.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#ifdef TRACKER_HAVE_ZSTD
+#  include <zstd.h>
+#endif
+#ifdef TRACKER_HAVE_LZ4
+#  include <lz4.h>
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#  error "binary streams are little-endian; add byte swapping for this target"
+#endif
+
+// ───────────────── codecs ───────────────────────────────────────────
+bin::Codec bin::codec_from(const std::string& name)
+{
+    Codec c;
+    if      (name == "none") c = Codec::None;
+    else if (name == "zstd") c = Codec::Zstd;
+    else if (name == "lz4")  c = Codec::Lz4;
+    else throw std::invalid_argument("unknown compression '" + name + "' (none | zstd | lz4)");
+    if (!codec_available(c)) throw std::invalid_argument(name + " compression was not built in");
+    return c;
+}
+
+const char* bin::codec_name(Codec c)
+{
+    switch (c) {
+    case Codec::None: return "none";
+    case Codec::Zstd: return "zstd";
+    case Codec::Lz4:  return "lz4";
+    }
+    return "?";
+}
+
+bool bin::codec_available(Codec c)
+{
+    switch (c) {
+    case Codec::None: return true;
+#ifdef TRACKER_HAVE_ZSTD
+    case Codec::Zstd: return true;
+#endif
+#ifdef TRACKER_HAVE_LZ4
+    case Codec::Lz4:  return true;
+#endif
+    default:          return false;
+    }
+}
+
+// ───────────────── varints, fixed point ─────────────────────────────
+namespace {
+
+constexpr std::uint16_t flag_streams = 1u << 1;
+constexpr int           codec_shift  = 8;
+
+std::uint64_t zigzag(std::int64_t v)    { return (std::uint64_t(v) << 1) ^ std::uint64_t(v >> 63); }
+std::int64_t  unzigzag(std::uint64_t v) { return std::int64_t(v >> 1) ^ -std::int64_t(v & 1); }
+
+void put_varint(std::vector<char>& b, std::uint64_t v)
+{
+    while (v >= 0x80) { b.push_back(static_cast<char>(v | 0x80)); v >>= 7; }
+    b.push_back(static_cast<char>(v));
+}
+
+void put_u16(std::vector<char>& b, std::uint16_t v)
+{
+    b.push_back(static_cast<char>(v & 0xff));
+    b.push_back(static_cast<char>(v >> 8));
+}
+
+[[noreturn]] void corrupt() { throw std::runtime_error("corrupt quantised label stream"); }
+
+std::uint64_t get_varint(const char*& p, const char* end)
+{
+    std::uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (p == end) corrupt();
+        const auto c = static_cast<unsigned char>(*p++);
+        v |= std::uint64_t(c & 0x7f) << shift;
+        if (!(c & 0x80)) return v;
+    }
+    corrupt();
+}
+
+std::uint16_t get_u16(const char*& p, const char* end)
+{
+    if (end - p < 2) corrupt();
+    const auto v = static_cast<std::uint16_t>(static_cast<unsigned char>(p[0]) |
+                                              static_cast<unsigned char>(p[1]) << 8);
+    p += 2;
+    return v;
+}
+
+std::uint16_t quantise(double v)
+{
+    const double q = std::round(v * 65535.0);
+    if (!(q > 0.0)) return 0;                                          // also NaN
+    return static_cast<std::uint16_t>(std::min(q, 65535.0));
+}
+
+double dequantise(std::uint16_t q) { return q / 65535.0; }
+
+std::uint64_t key(std::uint32_t stream, std::int32_t id)
+{
+    return std::uint64_t(stream) << 32 | static_cast<std::uint32_t>(id);
+}
+
+} // namespace
+
+// ───────────────── writer ───────────────────────────────────────────
+QuantLabelWriter::QuantLabelWriter(std::ostream& out, bool streams, bin::Codec codec,
+                                   std::uint32_t block_frames)
+    : out_(out), streams_(streams), codec_(codec), block_frames_(block_frames ? block_frames : 1)
+{
+    if (!bin::codec_available(codec_))
+        throw std::invalid_argument(std::string(bin::codec_name(codec_)) + " compression was not built in");
+#ifdef TRACKER_HAVE_ZSTD
+    if (codec_ == bin::Codec::Zstd && !(cctx_ = ZSTD_createCCtx())) throw std::bad_alloc();
+#endif
+    bin::FileHeader h{};
+    std::memcpy(h.magic, bin::quant_magic, 4);
+    h.version     = bin::quant_version;
+    h.flags       = static_cast<std::uint16_t>((streams_ ? flag_streams : 0) |
+                                               static_cast<unsigned>(codec_) << codec_shift);
+    h.reserved[0] = block_frames_;
+    out_.write(reinterpret_cast<const char*>(&h), sizeof h);
+}
+
+QuantLabelWriter::~QuantLabelWriter()
+{
+#ifdef TRACKER_HAVE_ZSTD
+    ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(cctx_));
+#endif
+}
+
+void QuantLabelWriter::write_stream(std::uint32_t stream, double ts, const std::vector<Label>& labels)
+{
+    const std::int64_t us = iso::to_us(ts);
+    put_varint(raw_, zigzag(us - prev_ts_));
+    prev_ts_ = us;
+    if (streams_) put_varint(raw_, stream);
+    put_varint(raw_, labels.size());
+
+    std::int32_t prev_id = 0;
+    for (const Label& L : labels) {
+        const std::array<std::uint16_t,4> q{quantise(L.det.x), quantise(L.det.y),
+                                            quantise(L.det.w), quantise(L.det.h)};
+        auto [it, fresh] = last_.try_emplace(key(stream, L.track_id), q);
+        put_varint(raw_, zigzag(std::int64_t(L.track_id) - prev_id) << 1 | (fresh ? 0u : 1u));
+        prev_id = L.track_id;
+        if (fresh) for (const auto c : q) put_u16(raw_, c);
+        else {
+            for (int k=0; k<4; ++k) put_varint(raw_, zigzag(std::int64_t(q[k]) - it->second[k]));
+            it->second = q;
+        }
+    }
+    if (++frames_ == block_frames_) flush_block();
+}
+
+void QuantLabelWriter::flush_block()
+{
+    if (!frames_) return;
+    if (raw_.size() > std::size_t(std::numeric_limits<int>::max()))
+        throw std::runtime_error("quantised label block too large; use fewer frames per block");
+
+    // a block that does not shrink is stored as is (stored == raw)
+    const char* data = raw_.data();
+    std::size_t stored = raw_.size();
+    switch (codec_) {
+    case bin::Codec::None: break;
+#ifdef TRACKER_HAVE_ZSTD
+    case bin::Codec::Zstd: {
+        packed_.resize(ZSTD_compressBound(raw_.size()));
+        const std::size_t n = ZSTD_compressCCtx(static_cast<ZSTD_CCtx*>(cctx_), packed_.data(), packed_.size(),
+                                                raw_.data(), raw_.size(), 3);
+        if (ZSTD_isError(n)) throw std::runtime_error(std::string("zstd: ") + ZSTD_getErrorName(n));
+        if (n < stored) { data = packed_.data(); stored = n; }
+        break;
+    }
+#endif
+#ifdef TRACKER_HAVE_LZ4
+    case bin::Codec::Lz4: {
+        packed_.resize(std::size_t(LZ4_compressBound(int(raw_.size()))));
+        const int n = LZ4_compress_default(raw_.data(), packed_.data(), int(raw_.size()), int(packed_.size()));
+        if (n <= 0) throw std::runtime_error("lz4: compression failed");
+        if (std::size_t(n) < stored) { data = packed_.data(); stored = std::size_t(n); }
+        break;
+    }
+#endif
+    default: break;
+    }
+
+    const bin::BlockHeader h{static_cast<std::uint32_t>(raw_.size()), static_cast<std::uint32_t>(stored),
+                             frames_, 0u};
+    out_.write(reinterpret_cast<const char*>(&h), sizeof h);
+    out_.write(data, static_cast<std::streamsize>(stored));
+    out_.flush();
+
+    raw_.clear();
+    last_.clear();
+    frames_  = 0;
+    prev_ts_ = 0;
+}
+
+void QuantLabelWriter::finish() { flush_block(); out_.flush(); }
+
+// ───────────────── reader ───────────────────────────────────────────
+QuantLabelReader::QuantLabelReader(const std::string& path) : file_(path)
+{
+    p_ = file_.data(); end_ = file_.data() + file_.size();
+    bin::FileHeader h;
+    if (file_.size() < sizeof h) throw std::runtime_error(path + " is not a quantised label stream");
+    std::memcpy(&h, p_, sizeof h);
+    if (std::memcmp(h.magic, bin::quant_magic, 4) != 0)
+        throw std::runtime_error(path + " is not a quantised label stream");
+    if (h.version != bin::quant_version)
+        throw std::runtime_error("unsupported quantised label stream version " + std::to_string(h.version));
+    streams_ = (h.flags & flag_streams) != 0;
+    codec_   = static_cast<bin::Codec>(h.flags >> codec_shift & 0xf);
+    if (!bin::codec_available(codec_))
+        throw std::runtime_error(path + ": " + bin::codec_name(codec_) + " compression was not built in");
+    p_ += sizeof h;
+}
+
+bool QuantLabelReader::load_block()
+{
+    if (p_ == end_) return false;
+    bin::BlockHeader h;
+    if (static_cast<std::size_t>(end_ - p_) < sizeof h) corrupt();
+    std::memcpy(&h, p_, sizeof h);
+    p_ += sizeof h;
+    if (h.stored > static_cast<std::size_t>(end_ - p_) || h.stored > h.raw || !h.frames) corrupt();
+
+    if (h.stored == h.raw) { q_ = p_; qend_ = p_ + h.raw; }        // stored as is
+    else {
+        raw_.resize(h.raw);
+        bool ok = false;
+        switch (codec_) {
+#ifdef TRACKER_HAVE_ZSTD
+        case bin::Codec::Zstd: {
+            const std::size_t n = ZSTD_decompress(raw_.data(), raw_.size(), p_, h.stored);
+            ok = !ZSTD_isError(n) && n == h.raw;
+            break;
+        }
+#endif
+#ifdef TRACKER_HAVE_LZ4
+        case bin::Codec::Lz4:
+            ok = LZ4_decompress_safe(p_, raw_.data(), int(h.stored), int(h.raw)) == int(h.raw);
+            break;
+#endif
+        default: break;
+        }
+        if (!ok) corrupt();
+        q_ = raw_.data(); qend_ = raw_.data() + h.raw;
+    }
+    p_ += h.stored;
+    left_    = h.frames;
+    prev_ts_ = 0;
+    last_.clear();
+    return true;
+}
+
+bool QuantLabelReader::next(double& ts, std::vector<Label>& labels, std::uint32_t* stream)
+{
+    if (!left_ && !load_block()) return false;
+    --left_;
+
+    prev_ts_ += unzigzag(get_varint(q_, qend_));
+    ts = iso::from_us(prev_ts_);
+    const std::uint32_t s = streams_ ? static_cast<std::uint32_t>(get_varint(q_, qend_)) : 0;
+    if (stream) *stream = s;
+    const std::uint64_t n = get_varint(q_, qend_);
+    if (n > static_cast<std::uint64_t>(qend_ - q_)) corrupt();        // >= 1 byte per label
+
+    labels.resize(n);
+    std::int64_t id = 0;
+    for (auto& L : labels) {
+        const std::uint64_t head = get_varint(q_, qend_);
+        id += unzigzag(head >> 1);
+        L.track_id = static_cast<std::int32_t>(id);
+        std::array<std::uint16_t,4> q;
+        if (!(head & 1)) {
+            for (auto& c : q) c = get_u16(q_, qend_);
+            last_[key(s, L.track_id)] = q;
+        } else {
+            const auto it = last_.find(key(s, L.track_id));
+            if (it == last_.end()) corrupt();
+            for (int k=0; k<4; ++k)
+                q[k] = static_cast<std::uint16_t>(it->second[k] + unzigzag(get_varint(q_, qend_)));
+            it->second = q;
+        }
+        L.det = {dequantise(q[0]), dequantise(q[1]), dequantise(q[2]), dequantise(q[3])};
+    }
+    if (!left_ && q_ != qend_) corrupt();
+    return true;
+}
@@ -0,0 +1,75 @@
+#include "SceneGen.hpp"
+#include "iso_time.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+double clamp(double v, double lo = 0.0, double hi = 1.0) { return std::max(lo, std::min(v, hi)); }
+}
+
+SceneGenerator::SceneGenerator(const SceneParams& p)
+    : p_(p), rng_(p.seed),
+      ts_(double(iso::days_from_civil(2025, 3, 24)) * 86400.0 + 18 * 3600.0)   // 2025-03-24T18:00:00
+{}
+
+bool SceneGenerator::next(Frame& fr)
+{
+    if (frame_ >= p_.frames) return false;
+    const int k = frame_++;
+
+    // ─── population: retire, then top up to a random target ───────
+    live_.erase(std::remove_if(live_.begin(), live_.end(),
+                               [&](const Object& o){ return o.end <= k; }),
+                live_.end());
+    const int spawn = randint(p_.min_objects, p_.max_objects) - static_cast<int>(live_.size());
+    for (int i=0; i<spawn; ++i) {
+        const int    life = randint(p_.min_life, p_.max_life);
+        const double s0   = uniform(p_.min_size, p_.max_size);
+        const double ax   = uniform(0.1, 0.8), ay = uniform(0.1, 0.8);
+        live_.push_back({next_id_++, std::min(k + life, p_.frames),
+                         ax, ay, ax, ay, s0, s0, 0, false});
+    }
+
+    // ─── timestamp ─────────────────────────────────────────────────
+    if (k > 0) ts_ += uniform(p_.dt_min, p_.dt_max);
+    fr.ts     = iso::from_us(iso::to_us(ts_));        // microsecond grid, as in JSON
+    fr.stream = 0;
+
+    // ─── global motion: bounded wind walk, rotation, zoom ──────────
+    wind_x_ += gauss(p_.wind_sigma);
+    wind_y_ += gauss(p_.wind_sigma);
+    const double mag = std::hypot(wind_x_, wind_y_);
+    if (mag > p_.wind_max) { wind_x_ *= p_.wind_max / mag; wind_y_ *= p_.wind_max / mag; }
+    const double theta = gauss(p_.rot_sigma);
+    const double scale = 1.0 + gauss(p_.scale_sigma);
+    const double cos_t = std::cos(theta), sin_t = std::sin(theta);
+
+    // ─── per object ────────────────────────────────────────────────
+    fr.dets.clear();
+    truth_.clear();
+    for (Object& o : live_) {
+        if (o.drop_remaining == 0 && o.seen_once && uniform(0.0, 1.0) < p_.drop_prob)
+            o.drop_remaining = randint(1, p_.drop_max);
+        const bool dropped = o.drop_remaining > 0;
+        if (dropped) --o.drop_remaining;
+
+        const double dx_obj = p_.step_max > 0.0 ? uniform(-p_.step_max, p_.step_max) : 0.0;
+        const double dy_obj = p_.step_max > 0.0 ? uniform(-p_.step_max, p_.step_max) : 0.0;
+        const double cx = o.ax + p_.bias_x + wind_x_ + dx_obj + gauss(p_.sway_sigma) - 0.5;
+        const double cy = o.ay + p_.bias_y + wind_y_ + dy_obj + gauss(p_.sway_sigma) - 0.5;
+        o.x = clamp(0.5 + scale * (cos_t*cx - sin_t*cy));
+        o.y = clamp(0.5 + scale * (sin_t*cx + cos_t*cy));
+
+        const double size_noise = gauss(p_.noise_size);
+        o.w = clamp(o.w * scale + size_noise, p_.min_size, p_.max_size);
+        o.h = clamp(o.h * scale + size_noise, p_.min_size, p_.max_size);
+
+        if (!dropped) {
+            fr.dets.push_back({clamp(o.x + gauss(p_.noise_pos)),
+                               clamp(o.y + gauss(p_.noise_pos)), o.w, o.h});
+            truth_.push_back(o.id);
+            o.seen_once = true;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,24 @@
+#include "SpatialGrid.hpp"
+
+void SpatialGrid::build(const std::vector<double>& x, const std::vector<double>& y,
+                        double radius)
+{
+    const int n = static_cast<int>(x.size());
+
+    // cell side 1/G_ >= radius; no more cells than ~2 per point
+    const int by_radius = radius > 0.0 ? static_cast<int>(1.0 / radius) : 1;
+    const int by_count  = static_cast<int>(std::sqrt(2.0 * n)) + 1;
+    G_ = std::max(1, std::min(by_radius, by_count));
+
+    const int ncell = G_*G_;
+    start_.assign(ncell + 1, 0);
+    cell_of_.resize(n);
+    for (int i=0; i<n; ++i) {
+        cell_of_[i] = cell(y[i])*G_ + cell(x[i]);
+        ++start_[cell_of_[i]];
+    }
+    for (int c=1; c<=ncell; ++c) start_[c] += start_[c-1];   // start_[c] = end of c
+
+    items_.resize(n);
+    for (int i=n-1; i>=0; --i) items_[--start_[cell_of_[i]]] = i;  // now begin of c
+}
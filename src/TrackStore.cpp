@@ -0,0 +1,549 @@
+#include "TrackStore.hpp"
+#include "kalman.hpp"
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#  include <arm_neon.h>
+#  define TRACKSTORE_NEON 1
+#endif
+
+// ───────────────── kernels ──────────────────────────────────────────
+// Each vector kernel handles as many whole lanes as it can and returns the
+// index where the scalar tail (built on the kf:: per-axis helpers) resumes.
+// Operations are issued in the same order as the scalar code so all paths
+// produce the same results.
+namespace {
+
+inline double clamp_dt(double dt) { return dt<=0 ? 1e-6 : dt; }
+
+/**
+ * dt and Q for every track last updated at `last_ts`, computed once per
+ * frame.  Tracks that matched in the previous frame all share that
+ * timestamp, so the kernels take these values instead of forming dt and
+ * Q per track; the others still get their own.  Same formulas, so the
+ * results are identical either way.
+ */
+template<class T>
+struct SharedStep
+{
+    double        last_ts;
+    T             dt;
+    kf::Noise<T>  q;
+};
+
+template<class T>
+SharedStep<T> shared_step(double ts, double last_ts)
+{
+    const T dt = T(clamp_dt(ts - last_ts));
+    return {last_ts, dt, kf::noise(dt)};
+}
+
+template<class T>
+void predict_scalar(BasicTrackStore<T>& s, double ts, const SharedStep<T>& c, std::size_t i0)
+{
+    for (std::size_t i=i0; i<s.size(); ++i) {
+        const bool        hit = s.last_ts[i] == c.last_ts;
+        const T           dt = hit ? c.dt : T(clamp_dt(ts - s.last_ts[i]));
+        const kf::Noise<T> q = hit ? c.q  : kf::noise(dt);
+        for (auto& a : s.ax)
+            kf::predict_axis(a.p[i], a.v[i], a.P00[i], a.P01[i], a.P11[i], dt, q);
+    }
+}
+
+template<class T>
+void correct_scalar(BasicTrackStore<T>& s, const std::array<std::vector<T>,4>& z,
+                    const std::vector<T>& mask, std::size_t i0)
+{
+    for (std::size_t i=i0; i<s.size(); ++i) {
+        if (mask[i] == T(0)) continue;
+        for (int k=0;k<4;++k) {
+            auto& a = s.ax[k];
+            kf::correct_axis(a.p[i], a.v[i], a.P00[i], a.P01[i], a.P11[i], z[k][i]);
+        }
+    }
+}
+
+#if defined(__AVX2__)
+std::size_t predict_simd(TrackStoreD& s, double ts, const SharedStep<double>& c)
+{
+    const std::size_t n = s.size() & ~std::size_t(3);
+    const __m256d vts  = _mm256_set1_pd(ts),   eps  = _mm256_set1_pd(1e-6),
+                  zero = _mm256_setzero_pd(),  pn   = _mm256_set1_pd(kf::proc_noise),
+                  quarter = _mm256_set1_pd(0.25), half = _mm256_set1_pd(0.5);
+    const __m256d clast = _mm256_set1_pd(c.last_ts), cdt = _mm256_set1_pd(c.dt),
+                  cq00 = _mm256_set1_pd(c.q.q00), cq01 = _mm256_set1_pd(c.q.q01),
+                  cq11 = _mm256_set1_pd(c.q.q11);
+
+    for (std::size_t i=0; i<n; i+=4) {
+        const __m256d last = _mm256_loadu_pd(&s.last_ts[i]);
+        __m256d dt = cdt, q00 = cq00, q01 = cq01, q11 = cq11;
+        if (_mm256_movemask_pd(_mm256_cmp_pd(last, clast, _CMP_EQ_OQ)) != 0xF) {
+            dt = _mm256_sub_pd(vts, last);
+            dt = _mm256_blendv_pd(dt, eps, _mm256_cmp_pd(dt, zero, _CMP_LE_OQ));
+            const __m256d dt2 = _mm256_mul_pd(dt,dt), dt3 = _mm256_mul_pd(dt2,dt),
+                          dt4 = _mm256_mul_pd(dt2,dt2);
+            q00 = _mm256_mul_pd(_mm256_mul_pd(dt4,quarter), pn);
+            q01 = _mm256_mul_pd(_mm256_mul_pd(dt3,half), pn);
+            q11 = _mm256_mul_pd(dt2, pn);
+        }
+
+        for (auto& a : s.ax) {
+            const __m256d p = _mm256_loadu_pd(&a.p[i]),   v = _mm256_loadu_pd(&a.v[i]);
+            const __m256d P00 = _mm256_loadu_pd(&a.P00[i]),
+                          P01 = _mm256_loadu_pd(&a.P01[i]),
+                          P11 = _mm256_loadu_pd(&a.P11[i]);
+            const __m256d t00 = _mm256_add_pd(P00, _mm256_mul_pd(dt,P01)),
+                          t01 = _mm256_add_pd(P01, _mm256_mul_pd(dt,P11));
+            _mm256_storeu_pd(&a.p[i],   _mm256_add_pd(p, _mm256_mul_pd(dt,v)));
+            _mm256_storeu_pd(&a.P00[i], _mm256_add_pd(_mm256_add_pd(t00, _mm256_mul_pd(dt,t01)), q00));
+            _mm256_storeu_pd(&a.P01[i], _mm256_add_pd(t01, q01));
+            _mm256_storeu_pd(&a.P11[i], _mm256_add_pd(P11, q11));
+        }
+    }
+    return n;
+}
+
+std::size_t correct_simd(TrackStoreD& s, const std::array<std::vector<double>,4>& z,
+                         const std::vector<double>& mask)
+{
+    const std::size_t n = s.size() & ~std::size_t(3);
+    const __m256d r = _mm256_set1_pd(kf::meas_noise), zero = _mm256_setzero_pd();
+
+    for (std::size_t i=0; i<n; i+=4) {
+        const __m256d m = _mm256_cmp_pd(_mm256_loadu_pd(&mask[i]), zero, _CMP_GT_OQ);
+        if (_mm256_movemask_pd(m) == 0) continue;
+
+        for (int k=0;k<4;++k) {
+            auto& a = s.ax[k];
+            const __m256d p = _mm256_loadu_pd(&a.p[i]),   v = _mm256_loadu_pd(&a.v[i]);
+            const __m256d P00 = _mm256_loadu_pd(&a.P00[i]),
+                          P01 = _mm256_loadu_pd(&a.P01[i]),
+                          P11 = _mm256_loadu_pd(&a.P11[i]);
+            const __m256d S   = _mm256_add_pd(P00, r);
+            const __m256d K0  = _mm256_div_pd(P00, S), K1 = _mm256_div_pd(P01, S);
+            const __m256d res = _mm256_sub_pd(_mm256_loadu_pd(&z[k][i]), p);
+            _mm256_storeu_pd(&a.p[i],   _mm256_blendv_pd(p,   _mm256_add_pd(p, _mm256_mul_pd(K0,res)), m));
+            _mm256_storeu_pd(&a.v[i],   _mm256_blendv_pd(v,   _mm256_add_pd(v, _mm256_mul_pd(K1,res)), m));
+            _mm256_storeu_pd(&a.P11[i], _mm256_blendv_pd(P11, _mm256_sub_pd(P11, _mm256_mul_pd(K1,P01)), m));
+            _mm256_storeu_pd(&a.P01[i], _mm256_blendv_pd(P01, _mm256_sub_pd(P01, _mm256_mul_pd(K0,P01)), m));
+            _mm256_storeu_pd(&a.P00[i], _mm256_blendv_pd(P00, _mm256_sub_pd(P00, _mm256_mul_pd(K0,P00)), m));
+        }
+    }
+    return n;
+}
+// float: 8 lanes; dt is formed in double from the double timestamps
+std::size_t predict_simd(TrackStoreF& s, double ts, const SharedStep<float>& c)
+{
+    const std::size_t n = s.size() & ~std::size_t(7);
+    const __m256d vts  = _mm256_set1_pd(ts),   eps  = _mm256_set1_pd(1e-6),
+                  zero = _mm256_setzero_pd(),  clast = _mm256_set1_pd(c.last_ts);
+    const __m256  pn   = _mm256_set1_ps(float(kf::proc_noise)),
+                  quarter = _mm256_set1_ps(0.25f), half = _mm256_set1_ps(0.5f);
+    const __m256  cdt  = _mm256_set1_ps(c.dt),
+                  cq00 = _mm256_set1_ps(c.q.q00), cq01 = _mm256_set1_ps(c.q.q01),
+                  cq11 = _mm256_set1_ps(c.q.q11);
+
+    for (std::size_t i=0; i<n; i+=8) {
+        const __m256d llo = _mm256_loadu_pd(&s.last_ts[i]), lhi = _mm256_loadu_pd(&s.last_ts[i+4]);
+        __m256 dt = cdt, q00 = cq00, q01 = cq01, q11 = cq11;
+        if ((_mm256_movemask_pd(_mm256_cmp_pd(llo, clast, _CMP_EQ_OQ)) &
+             _mm256_movemask_pd(_mm256_cmp_pd(lhi, clast, _CMP_EQ_OQ))) != 0xF) {
+            __m256d lo = _mm256_sub_pd(vts, llo), hi = _mm256_sub_pd(vts, lhi);
+            lo = _mm256_blendv_pd(lo, eps, _mm256_cmp_pd(lo, zero, _CMP_LE_OQ));
+            hi = _mm256_blendv_pd(hi, eps, _mm256_cmp_pd(hi, zero, _CMP_LE_OQ));
+            dt = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(lo)),
+                                      _mm256_cvtpd_ps(hi), 1);
+            const __m256 dt2 = _mm256_mul_ps(dt,dt), dt3 = _mm256_mul_ps(dt2,dt),
+                         dt4 = _mm256_mul_ps(dt2,dt2);
+            q00 = _mm256_mul_ps(_mm256_mul_ps(dt4,quarter), pn);
+            q01 = _mm256_mul_ps(_mm256_mul_ps(dt3,half), pn);
+            q11 = _mm256_mul_ps(dt2, pn);
+        }
+
+        for (auto& a : s.ax) {
+            const __m256 p = _mm256_loadu_ps(&a.p[i]),   v = _mm256_loadu_ps(&a.v[i]);
+            const __m256 P00 = _mm256_loadu_ps(&a.P00[i]),
+                         P01 = _mm256_loadu_ps(&a.P01[i]),
+                         P11 = _mm256_loadu_ps(&a.P11[i]);
+            const __m256 t00 = _mm256_add_ps(P00, _mm256_mul_ps(dt,P01)),
+                         t01 = _mm256_add_ps(P01, _mm256_mul_ps(dt,P11));
+            _mm256_storeu_ps(&a.p[i],   _mm256_add_ps(p, _mm256_mul_ps(dt,v)));
+            _mm256_storeu_ps(&a.P00[i], _mm256_add_ps(_mm256_add_ps(t00, _mm256_mul_ps(dt,t01)), q00));
+            _mm256_storeu_ps(&a.P01[i], _mm256_add_ps(t01, q01));
+            _mm256_storeu_ps(&a.P11[i], _mm256_add_ps(P11, q11));
+        }
+    }
+    return n;
+}
+
+std::size_t correct_simd(TrackStoreF& s, const std::array<std::vector<float>,4>& z,
+                         const std::vector<float>& mask)
+{
+    const std::size_t n = s.size() & ~std::size_t(7);
+    const __m256 r = _mm256_set1_ps(float(kf::meas_noise)), zero = _mm256_setzero_ps();
+
+    for (std::size_t i=0; i<n; i+=8) {
+        const __m256 m = _mm256_cmp_ps(_mm256_loadu_ps(&mask[i]), zero, _CMP_GT_OQ);
+        if (_mm256_movemask_ps(m) == 0) continue;
+
+        for (int k=0;k<4;++k) {
+            auto& a = s.ax[k];
+            const __m256 p = _mm256_loadu_ps(&a.p[i]),   v = _mm256_loadu_ps(&a.v[i]);
+            const __m256 P00 = _mm256_loadu_ps(&a.P00[i]),
+                         P01 = _mm256_loadu_ps(&a.P01[i]),
+                         P11 = _mm256_loadu_ps(&a.P11[i]);
+            const __m256 S   = _mm256_add_ps(P00, r);
+            const __m256 K0  = _mm256_div_ps(P00, S), K1 = _mm256_div_ps(P01, S);
+            const __m256 res = _mm256_sub_ps(_mm256_loadu_ps(&z[k][i]), p);
+            _mm256_storeu_ps(&a.p[i],   _mm256_blendv_ps(p,   _mm256_add_ps(p, _mm256_mul_ps(K0,res)), m));
+            _mm256_storeu_ps(&a.v[i],   _mm256_blendv_ps(v,   _mm256_add_ps(v, _mm256_mul_ps(K1,res)), m));
+            _mm256_storeu_ps(&a.P11[i], _mm256_blendv_ps(P11, _mm256_sub_ps(P11, _mm256_mul_ps(K1,P01)), m));
+            _mm256_storeu_ps(&a.P01[i], _mm256_blendv_ps(P01, _mm256_sub_ps(P01, _mm256_mul_ps(K0,P01)), m));
+            _mm256_storeu_ps(&a.P00[i], _mm256_blendv_ps(P00, _mm256_sub_ps(P00, _mm256_mul_ps(K0,P00)), m));
+        }
+    }
+    return n;
+}
+#elif defined(TRACKSTORE_NEON)
+std::size_t predict_simd(TrackStoreD& s, double ts, const SharedStep<double>& c)
+{
+    const std::size_t n = s.size() & ~std::size_t(1);
+    const float64x2_t vts  = vdupq_n_f64(ts),  eps  = vdupq_n_f64(1e-6),
+                      zero = vdupq_n_f64(0.0), pn   = vdupq_n_f64(kf::proc_noise),
+                      quarter = vdupq_n_f64(0.25), half = vdupq_n_f64(0.5);
+    const float64x2_t clast = vdupq_n_f64(c.last_ts), cdt = vdupq_n_f64(c.dt),
+                      cq00 = vdupq_n_f64(c.q.q00), cq01 = vdupq_n_f64(c.q.q01),
+                      cq11 = vdupq_n_f64(c.q.q11);
+
+    for (std::size_t i=0; i<n; i+=2) {
+        const float64x2_t last = vld1q_f64(&s.last_ts[i]);
+        const uint64x2_t  same = vceqq_f64(last, clast);
+        float64x2_t dt = cdt, q00 = cq00, q01 = cq01, q11 = cq11;
+        if ((vgetq_lane_u64(same,0) & vgetq_lane_u64(same,1)) == 0) {
+            dt = vsubq_f64(vts, last);
+            dt = vbslq_f64(vcleq_f64(dt, zero), eps, dt);
+            const float64x2_t dt2 = vmulq_f64(dt,dt), dt3 = vmulq_f64(dt2,dt),
+                              dt4 = vmulq_f64(dt2,dt2);
+            q00 = vmulq_f64(vmulq_f64(dt4,quarter), pn);
+            q01 = vmulq_f64(vmulq_f64(dt3,half), pn);
+            q11 = vmulq_f64(dt2, pn);
+        }
+
+        for (auto& a : s.ax) {
+            const float64x2_t p = vld1q_f64(&a.p[i]),   v = vld1q_f64(&a.v[i]);
+            const float64x2_t P00 = vld1q_f64(&a.P00[i]),
+                              P01 = vld1q_f64(&a.P01[i]),
+                              P11 = vld1q_f64(&a.P11[i]);
+            const float64x2_t t00 = vaddq_f64(P00, vmulq_f64(dt,P01)),
+                              t01 = vaddq_f64(P01, vmulq_f64(dt,P11));
+            vst1q_f64(&a.p[i],   vaddq_f64(p, vmulq_f64(dt,v)));
+            vst1q_f64(&a.P00[i], vaddq_f64(vaddq_f64(t00, vmulq_f64(dt,t01)), q00));
+            vst1q_f64(&a.P01[i], vaddq_f64(t01, q01));
+            vst1q_f64(&a.P11[i], vaddq_f64(P11, q11));
+        }
+    }
+    return n;
+}
+
+std::size_t correct_simd(TrackStoreD& s, const std::array<std::vector<double>,4>& z,
+                         const std::vector<double>& mask)
+{
+    const std::size_t n = s.size() & ~std::size_t(1);
+    const float64x2_t r = vdupq_n_f64(kf::meas_noise), zero = vdupq_n_f64(0.0);
+
+    for (std::size_t i=0; i<n; i+=2) {
+        const uint64x2_t m = vcgtq_f64(vld1q_f64(&mask[i]), zero);
+        if ((vgetq_lane_u64(m,0) | vgetq_lane_u64(m,1)) == 0) continue;
+
+        for (int k=0;k<4;++k) {
+            auto& a = s.ax[k];
+            const float64x2_t p = vld1q_f64(&a.p[i]),   v = vld1q_f64(&a.v[i]);
+            const float64x2_t P00 = vld1q_f64(&a.P00[i]),
+                              P01 = vld1q_f64(&a.P01[i]),
+                              P11 = vld1q_f64(&a.P11[i]);
+            const float64x2_t S   = vaddq_f64(P00, r);
+            const float64x2_t K0  = vdivq_f64(P00, S), K1 = vdivq_f64(P01, S);
+            const float64x2_t res = vsubq_f64(vld1q_f64(&z[k][i]), p);
+            vst1q_f64(&a.p[i],   vbslq_f64(m, vaddq_f64(p, vmulq_f64(K0,res)), p));
+            vst1q_f64(&a.v[i],   vbslq_f64(m, vaddq_f64(v, vmulq_f64(K1,res)), v));
+            vst1q_f64(&a.P11[i], vbslq_f64(m, vsubq_f64(P11, vmulq_f64(K1,P01)), P11));
+            vst1q_f64(&a.P01[i], vbslq_f64(m, vsubq_f64(P01, vmulq_f64(K0,P01)), P01));
+            vst1q_f64(&a.P00[i], vbslq_f64(m, vsubq_f64(P00, vmulq_f64(K0,P00)), P00));
+        }
+    }
+    return n;
+}
+// float: 4 lanes; dt is formed in double from the double timestamps
+std::size_t predict_simd(TrackStoreF& s, double ts, const SharedStep<float>& c)
+{
+    const std::size_t n = s.size() & ~std::size_t(3);
+    const float64x2_t vts  = vdupq_n_f64(ts),  eps  = vdupq_n_f64(1e-6),
+                      zero = vdupq_n_f64(0.0), clast = vdupq_n_f64(c.last_ts);
+    const float32x4_t pn   = vdupq_n_f32(float(kf::proc_noise)),
+                      quarter = vdupq_n_f32(0.25f), half = vdupq_n_f32(0.5f);
+    const float32x4_t cdt  = vdupq_n_f32(c.dt),
+                      cq00 = vdupq_n_f32(c.q.q00), cq01 = vdupq_n_f32(c.q.q01),
+                      cq11 = vdupq_n_f32(c.q.q11);
+
+    for (std::size_t i=0; i<n; i+=4) {
+        const float64x2_t llo = vld1q_f64(&s.last_ts[i]), lhi = vld1q_f64(&s.last_ts[i+2]);
+        const uint64x2_t  same = vandq_u64(vceqq_f64(llo, clast), vceqq_f64(lhi, clast));
+        float32x4_t dt = cdt, q00 = cq00, q01 = cq01, q11 = cq11;
+        if ((vgetq_lane_u64(same,0) & vgetq_lane_u64(same,1)) == 0) {
+            float64x2_t lo = vsubq_f64(vts, llo), hi = vsubq_f64(vts, lhi);
+            lo = vbslq_f64(vcleq_f64(lo, zero), eps, lo);
+            hi = vbslq_f64(vcleq_f64(hi, zero), eps, hi);
+            dt = vcombine_f32(vcvt_f32_f64(lo), vcvt_f32_f64(hi));
+            const float32x4_t dt2 = vmulq_f32(dt,dt), dt3 = vmulq_f32(dt2,dt),
+                              dt4 = vmulq_f32(dt2,dt2);
+            q00 = vmulq_f32(vmulq_f32(dt4,quarter), pn);
+            q01 = vmulq_f32(vmulq_f32(dt3,half), pn);
+            q11 = vmulq_f32(dt2, pn);
+        }
+
+        for (auto& a : s.ax) {
+            const float32x4_t p = vld1q_f32(&a.p[i]),   v = vld1q_f32(&a.v[i]);
+            const float32x4_t P00 = vld1q_f32(&a.P00[i]),
+                              P01 = vld1q_f32(&a.P01[i]),
+                              P11 = vld1q_f32(&a.P11[i]);
+            const float32x4_t t00 = vaddq_f32(P00, vmulq_f32(dt,P01)),
+                              t01 = vaddq_f32(P01, vmulq_f32(dt,P11));
+            vst1q_f32(&a.p[i],   vaddq_f32(p, vmulq_f32(dt,v)));
+            vst1q_f32(&a.P00[i], vaddq_f32(vaddq_f32(t00, vmulq_f32(dt,t01)), q00));
+            vst1q_f32(&a.P01[i], vaddq_f32(t01, q01));
+            vst1q_f32(&a.P11[i], vaddq_f32(P11, q11));
+        }
+    }
+    return n;
+}
+
+std::size_t correct_simd(TrackStoreF& s, const std::array<std::vector<float>,4>& z,
+                         const std::vector<float>& mask)
+{
+    const std::size_t n = s.size() & ~std::size_t(3);
+    const float32x4_t r = vdupq_n_f32(float(kf::meas_noise)), zero = vdupq_n_f32(0.0f);
+
+    for (std::size_t i=0; i<n; i+=4) {
+        const uint32x4_t m = vcgtq_f32(vld1q_f32(&mask[i]), zero);
+        if (vmaxvq_u32(m) == 0) continue;
+
+        for (int k=0;k<4;++k) {
+            auto& a = s.ax[k];
+            const float32x4_t p = vld1q_f32(&a.p[i]),   v = vld1q_f32(&a.v[i]);
+            const float32x4_t P00 = vld1q_f32(&a.P00[i]),
+                              P01 = vld1q_f32(&a.P01[i]),
+                              P11 = vld1q_f32(&a.P11[i]);
+            const float32x4_t S   = vaddq_f32(P00, r);
+            const float32x4_t K0  = vdivq_f32(P00, S), K1 = vdivq_f32(P01, S);
+            const float32x4_t res = vsubq_f32(vld1q_f32(&z[k][i]), p);
+            vst1q_f32(&a.p[i],   vbslq_f32(m, vaddq_f32(p, vmulq_f32(K0,res)), p));
+            vst1q_f32(&a.v[i],   vbslq_f32(m, vaddq_f32(v, vmulq_f32(K1,res)), v));
+            vst1q_f32(&a.P11[i], vbslq_f32(m, vsubq_f32(P11, vmulq_f32(K1,P01)), P11));
+            vst1q_f32(&a.P01[i], vbslq_f32(m, vsubq_f32(P01, vmulq_f32(K0,P01)), P01));
+            vst1q_f32(&a.P00[i], vbslq_f32(m, vsubq_f32(P00, vmulq_f32(K0,P00)), P00));
+        }
+    }
+    return n;
+}
+#else
+template<class T>
+std::size_t predict_simd(BasicTrackStore<T>&, double, const SharedStep<T>&) { return 0; }
+template<class T>
+std::size_t correct_simd(BasicTrackStore<T>&, const std::array<std::vector<T>,4>&,
+                         const std::vector<T>&) { return 0; }
+#endif
+
+// ─── snapshot columns ───────────────────────────────────────────────
+template<class V>
+void put_col(std::ostream& out, const std::vector<V>& c)
+{
+    out.write(reinterpret_cast<const char*>(c.data()), std::streamsize(c.size() * sizeof(V)));
+}
+
+template<class V>
+void get_col(std::istream& in, std::vector<V>& c, std::size_t n)
+{
+    c.resize(n);
+    in.read(reinterpret_cast<char*>(c.data()), std::streamsize(n * sizeof(V)));
+    if (std::size_t(in.gcount()) != n * sizeof(V)) throw std::runtime_error("truncated tracker snapshot");
+}
+
+} // namespace
+
+// ───────────────── store ────────────────────────────────────────────
+template<class T>
+void BasicTrackStore<T>::push(int track_id, double ts, const BasicDetection<T>& d)
+{
+    id.push_back(track_id);
+    last_ts.push_back(ts);
+    age.push_back(0);
+    time_since_update.push_back(0);
+    dual.push_back(std::numeric_limits<double>::quiet_NaN());
+    latest_ts_ = ts;
+
+    const T z[4] = {d.x, d.y, d.w, d.h};
+    for (int k=0;k<4;++k) {
+        ax[k].p.push_back(z[k]);   ax[k].v.push_back(T(0));
+        ax[k].P00.push_back(T(1)); ax[k].P01.push_back(T(0)); ax[k].P11.push_back(T(1));
+    }
+    take_slot(size() - 1);
+}
+
+template<class T>
+void BasicTrackStore<T>::take_slot(std::size_t i)
+{
+    std::uint32_t s;
+    if (free_.empty()) {
+        s = static_cast<std::uint32_t>(gen_.size());
+        gen_.push_back(0);
+        index_.push_back(0);
+    }
+    else { s = free_.back(); free_.pop_back(); }
+    index_[s] = i;
+    slot_.push_back(s);
+}
+
+template<class T>
+void BasicTrackStore<T>::release_slots()
+{
+    for (const std::uint32_t s : slot_) { ++gen_[s]; free_.push_back(s); }
+    slot_.clear();
+}
+
+template<class T>
+void BasicTrackStore<T>::reserve(std::size_t n)
+{
+    id.reserve(n); last_ts.reserve(n); age.reserve(n); time_since_update.reserve(n); dual.reserve(n);
+    for (auto& a : ax) { a.p.reserve(n); a.v.reserve(n); a.P00.reserve(n); a.P01.reserve(n); a.P11.reserve(n); }
+    for (auto& c : z_) c.reserve(n);
+    mask_.reserve(n);
+    slot_.reserve(n); index_.reserve(n); gen_.reserve(n); free_.reserve(n);
+}
+
+template<class T>
+void BasicTrackStore<T>::predict(double ts, bool count_miss)
+{
+    const SharedStep<T> c = shared_step<T>(ts, latest_ts_);
+    predict_scalar(*this, ts, c, predict_simd(*this, ts, c));
+    age_all(count_miss);
+}
+
+template<class T>
+void BasicTrackStore<T>::age_all(bool count_miss)
+{
+    for (std::size_t i=0; i<size(); ++i) ++age[i];
+    if (count_miss) for (std::size_t i=0; i<size(); ++i) ++time_since_update[i];
+}
+
+template<class T>
+void BasicTrackStore<T>::correct(double ts, const int* tr2det, const BasicDetection<T>* dets)
+{
+    const std::size_t n = size();
+    for (auto& c : z_) c.resize(n);
+    mask_.resize(n);
+
+    for (std::size_t i=0; i<n; ++i) {
+        const int di = tr2det[i];
+        if (di < 0) { mask_[i] = T(0); for (auto& c : z_) c[i] = T(0); continue; }
+        const BasicDetection<T>& d = dets[di];
+        mask_[i] = T(1);
+        z_[0][i] = d.x; z_[1][i] = d.y; z_[2][i] = d.w; z_[3][i] = d.h;
+    }
+
+    correct_scalar(*this, z_, mask_, correct_simd(*this, z_, mask_));
+    mark_updated(ts, tr2det);
+}
+
+template<class T>
+void BasicTrackStore<T>::mark_updated(double ts, const int* tr2det)
+{
+    latest_ts_ = ts;
+    for (std::size_t i=0; i<size(); ++i) if (tr2det[i] >= 0) {
+        last_ts[i] = ts;
+        time_since_update[i] = 0;
+    }
+}
+
+template<class T>
+void BasicTrackStore<T>::cull(int max_age)
+{
+    std::size_t i = 0;
+    while (i < size()) {
+        if (time_since_update[i] > max_age) remove(i);   // re-test the track moved in
+        else ++i;
+    }
+}
+
+template<class T>
+void BasicTrackStore<T>::remove(std::size_t i)
+{
+    const std::size_t last = size() - 1;
+    const std::uint32_t s = slot_[i];
+    if (i != last) move_slot(last, i);
+    slot_[last] = s;                       // pop_back() frees the removed track's slot
+    pop_back();
+}
+
+template<class T>
+void BasicTrackStore<T>::clear()
+{
+    release_slots();
+    id.clear(); last_ts.clear(); age.clear(); time_since_update.clear(); dual.clear();
+    latest_ts_ = std::numeric_limits<double>::quiet_NaN();
+    for (auto& a : ax) { a.p.clear(); a.v.clear(); a.P00.clear(); a.P01.clear(); a.P11.clear(); }
+}
+
+template<class T>
+void BasicTrackStore<T>::save(std::ostream& out) const
+{
+    out.write(reinterpret_cast<const char*>(&latest_ts_), sizeof latest_ts_);
+    put_col(out, id); put_col(out, age); put_col(out, time_since_update);
+    put_col(out, last_ts); put_col(out, dual);
+    for (const auto& a : ax) { put_col(out, a.p); put_col(out, a.v); put_col(out, a.P00); put_col(out, a.P01); put_col(out, a.P11); }
+}
+
+template<class T>
+void BasicTrackStore<T>::restore(std::istream& in, std::size_t n)
+{
+    std::vector<double> latest;
+    get_col(in, latest, 1);
+    latest_ts_ = latest[0];
+    release_slots();
+    get_col(in, id, n); get_col(in, age, n); get_col(in, time_since_update, n);
+    get_col(in, last_ts, n); get_col(in, dual, n);
+    for (auto& a : ax) { get_col(in, a.p, n); get_col(in, a.v, n); get_col(in, a.P00, n); get_col(in, a.P01, n); get_col(in, a.P11, n); }
+    for (std::size_t i=0; i<n; ++i) take_slot(i);
+}
+
+template<class T>
+void BasicTrackStore<T>::move_slot(std::size_t from, std::size_t to)
+{
+    id[to] = id[from];
+    last_ts[to] = last_ts[from];
+    age[to] = age[from];
+    time_since_update[to] = time_since_update[from];
+    dual[to] = dual[from];
+    slot_[to] = slot_[from];
+    index_[slot_[to]] = to;
+    for (auto& a : ax) {
+        a.p[to] = a.p[from];     a.v[to] = a.v[from];
+        a.P00[to] = a.P00[from]; a.P01[to] = a.P01[from]; a.P11[to] = a.P11[from];
+    }
+}
+
+template<class T>
+void BasicTrackStore<T>::pop_back()
+{
+    id.pop_back(); last_ts.pop_back(); age.pop_back(); time_since_update.pop_back(); dual.pop_back();
+    const std::uint32_t s = slot_.back();
+    ++gen_[s]; free_.push_back(s); slot_.pop_back();
+    for (auto& a : ax) { a.p.pop_back(); a.v.pop_back(); a.P00.pop_back(); a.P01.pop_back(); a.P11.pop_back(); }
+}
+
+template class BasicTrackStore<float>;
+template class BasicTrackStore<double>;
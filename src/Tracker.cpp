@@ -1,209 +1,585 @@
 #include "Tracker.hpp"
-#include "hungarian.hpp"          // minimal Hungarian solver
+#include "alloc_count.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <istream>
 #include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
 
 using namespace std;
 
 // ───────────────── utility helpers ──────────────────────────────────
-double Tracker::centre_dist(const Detection& d, const Track& t)
+template<class T>
+T BasicTracker<T>::centre_dist(const BasicDetection<T>& d, const std::array<T,4>& r)
 {
-    const double cx_d = d.x + d.w * 0.5,
-                 cy_d = d.y + d.h * 0.5;
+    return gate::centre_dist(d, r[0], r[1], r[2], r[3]);
+}
 
-    const double cx_t = t.rect.at<double>(0) + t.rect.at<double>(2) * 0.5,
-                 cy_t = t.rect.at<double>(1) + t.rect.at<double>(3) * 0.5;
+template<class T>
+T BasicTracker<T>::iou(const std::array<T,4>& r, const BasicDetection<T>& d)
+{
+    return gate::iou(r[0], r[1], r[2], r[3], d);
+}
 
-    return std::hypot(cx_d - cx_t, cy_d - cy_t);
+Assigner assigner_from(const std::string& name)
+{
+    if (name == "dense")   return Assigner::Dense;
+    if (name == "sparse")  return Assigner::Sparse;
+    if (name == "cascade") return Assigner::Cascade;
+    throw std::invalid_argument("unknown assigner '" + name + "'");
 }
 
-double Tracker::iou(const Track& t, const Detection& d)
+// ───────────────── constructor ──────────────────────────────────────
+template<class T>
+BasicTracker<T>::BasicTracker(double md,int ma,double a,Assigner as,bool warm,double fast_iou)
+    : max_dist_(T(md)), alpha_(T(a)), max_age_(ma), next_id_(0), assigner_(as),
+      warm_start_(warm), fast_iou_(T(fast_iou)) {}
+
+// ───────────────── gating ───────────────────────────────────────────
+template<class T>
+void BasicTracker<T>::gate_pair(int ti,int di,const Det& d,
+                                std::vector<Edge>& edges,std::vector<T>& ious) const
 {
-    const double ax=t.rect.at<double>(0), ay=t.rect.at<double>(1),
-                 aw=t.rect.at<double>(2), ah=t.rect.at<double>(3);
-    const double bx=d.x, by=d.y, bw=d.w, bh=d.h;
+    const std::array<T,4> r = tracks_.rect(ti);
+
+    T dist = centre_dist(d, r);
+    if (dist > max_dist_) return;
 
-    const double x1 = std::max(ax,bx),
-                 y1 = std::max(ay,by),
-                 x2 = std::min(ax+aw, bx+bw),
-                 y2 = std::min(ay+ah, by+bh);
+    T j = iou(r, d);
+    if (j < T(0.01))      return;
+
+    edges.push_back({ti, di, alpha_*(T(1)-j) + (T(1)-alpha_)*dist});
+    ious.push_back(j);
+}
+
+/** Dense: detections [lo, hi) against every track, through the batched kernel. */
+template<class T>
+void BasicTracker<T>::gate_all(const Det* dets,int lo,int hi,gate::Candidates<T>& cand,
+                               std::vector<Edge>& edges,std::vector<T>& ious) const
+{
+    const gate::Boxes<T> boxes{tracks_.ax[0].p.data(), tracks_.ax[1].p.data(),
+                               tracks_.ax[2].p.data(), tracks_.ax[3].p.data(), tracks_.size()};
+    const gate::Gate<T> g{max_dist_, T(0.01), alpha_};
+    for (int di=lo; di<hi; ++di) {
+        cand.clear();
+        gate::candidates(dets[di], boxes, g, cand);
+        for (std::size_t k=0; k<cand.size(); ++k) {
+            edges.push_back({cand.index[k], di, cand.cost[k]});
+            ious.push_back(cand.iou[k]);
+        }
+    }
+}
 
-    const double inter = std::max(0.0,x2-x1) * std::max(0.0,y2-y1);
-    const double uni   = aw*ah + bw*bh - inter;
+template<class T>
+void BasicTracker<T>::gate_grid(const Det* dets,int nD,bool parallel)
+{
+    const int nT = static_cast<int>(tracks_.size());
+    cx_.resize(nT); cy_.resize(nT);
+    for (int ti=0; ti<nT; ++ti) {
+        cx_[ti] = tracks_.ax[0].p[ti] + tracks_.ax[2].p[ti] * T(0.5);
+        cy_[ti] = tracks_.ax[1].p[ti] + tracks_.ax[3].p[ti] * T(0.5);
+    }
+    grid_.build(cx_, cy_, max_dist_);
+    if (parallel) return gate_parallel(dets, nD, true);
 
-    return (uni>0.0 ? inter/uni : 0.0);
+    for (int di=0; di<nD; ++di) {
+        const Det& d = dets[di];
+        grid_.query(d.x + d.w*T(0.5), d.y + d.h*T(0.5),
+                    [&](int ti){ gate_pair(ti, di, d, edges_, edge_iou_); });
+    }
 }
 
-cv::Mat Tracker::det2meas(const Detection& d)
+/**
+ * Detections split into contiguous parts in the serial loop order;
+ * concatenating the parts' candidates in part order reproduces edges_
+ * exactly.
+ */
+template<class T>
+void BasicTracker<T>::gate_parallel(const Det* dets,int nD,bool grid)
 {
-    cv::Mat m(4,1,CV_64F);
-    m.at<double>(0)=d.x; m.at<double>(1)=d.y;
-    m.at<double>(2)=d.w; m.at<double>(3)=d.h;
-    return m;
+    const int n = nD;
+    const std::size_t parts = std::min<std::size_t>(std::size_t(n), 4 * std::size_t(pool_.threads()));
+    part_edges_.resize(std::max(part_edges_.size(), parts));
+    part_iou_.resize(std::max(part_iou_.size(), parts));
+    part_cand_.resize(std::max(part_cand_.size(), parts));
+
+    auto part = [&](std::size_t p) {
+        auto& edges = part_edges_[p];
+        auto& ious  = part_iou_[p];
+        edges.clear(); ious.clear();
+        const int lo = int(std::size_t(n) * p / parts), hi = int(std::size_t(n) * (p+1) / parts);
+        if (grid)
+            for (int di=lo; di<hi; ++di) {
+                const Det& d = dets[di];
+                grid_.query(d.x + d.w*T(0.5), d.y + d.h*T(0.5),
+                            [&](int ti){ gate_pair(ti, di, d, edges, ious); });
+            }
+        else gate_all(dets, lo, hi, part_cand_[p], edges, ious);
+    };
+    pool_.run(parts, part);
+
+    for (std::size_t p=0; p<parts; ++p) {
+        edges_.insert(edges_.end(), part_edges_[p].begin(), part_edges_[p].end());
+        edge_iou_.insert(edge_iou_.end(), part_iou_[p].begin(), part_iou_[p].end());
+    }
+    metrics_.add(metrics::ParallelGates, 1);
 }
 
-void Tracker::set_F(cv::KalmanFilter& kf,double dt)
+// ───────────────── association back-ends ────────────────────────────
+template<class T>
+void BasicTracker<T>::solve_dense(int N,int nr,const int* track_of_row,T BIG)
 {
-    auto& F = kf.transitionMatrix;
-    F.at<double>(0,2)=dt;
-    F.at<double>(1,3)=dt;
-    F.at<double>(4,6)=dt;
-    F.at<double>(5,7)=dt;
+    // warm start from the row potentials surviving tracks kept from the
+    // last solve; cold when too few of them survive to pay for the seeding
+    auto track = [&](int r){ return track_of_row ? track_of_row[r] : r; };
+    double tot = 0.0;
+    int known = 0;
+    dual_.assign(N, 0.0); known_.assign(N, 0);
+    if (warm_start_)
+        for (int r=0;r<nr;++r) {
+            const double u = tracks_.dual[track(r)];
+            if (!std::isnan(u)) { dual_[r] = u; known_[r] = 1; ++known; }
+        }
+    if (known > 0 && 2*known >= N) {
+        const int seeded = hungarian_warm(cost_.data(), N, dual_.data(), known_.data(), double(BIG),
+                                          rowsol_, tot, hungarian_ws_);
+        metrics_.add(metrics::WarmSeeded, seeded);
+    }
+    else {
+        hungarian(cost_.data(), N, rowsol_, tot, hungarian_ws_);
+        for (int i=0;i<N;++i) dual_[i] = hungarian_ws_.u[i+1];
+    }
+    // potentials that absorbed a BIG cell would cost precision next frame
+    for (int r=0;r<nr;++r)
+        tracks_.dual[track(r)] = std::fabs(dual_[r]) < 0.5*double(BIG) ? dual_[r]
+                                                               : std::numeric_limits<double>::quiet_NaN();
 }
 
-void Tracker::set_Q(cv::KalmanFilter& kf,double dt,double s)
+template<class T>
+std::size_t BasicTracker<T>::assign_dense(int nT,int nD)
 {
-    const double dt2=dt*dt, dt3=dt2*dt, dt4=dt2*dt2;
-    cv::Mat Q = cv::Mat::zeros(8,8,CV_64F);
+    const int N  = std::max(nT,nD);
+    const T BIG = T(1e9);                 // exact in float too
+
+    // row-major N x N; real block BIG except gated pairs, dummy rows/cols 0
+    cost_.assign(std::size_t(N)*N, T(0));
+    for (int i=0;i<nT;++i) std::fill_n(&cost_[std::size_t(i)*N], nD, BIG);
+    for (const auto& e : edges_) cost_[std::size_t(e.row)*N + e.col] = e.cost;
 
-    // pos-vel (x,y)
-    Q.at<double>(0,0)=Q.at<double>(1,1)=dt4/4*s;
-    Q.at<double>(0,2)=Q.at<double>(1,3)=dt3/2*s;
-    Q.at<double>(2,0)=Q.at<double>(3,1)=dt3/2*s;
-    Q.at<double>(2,2)=Q.at<double>(3,3)=dt2*s;
+    solve_dense(N, nT, nullptr, BIG);
 
-    // size-vel (w,h)
-    Q.at<double>(4,4)=Q.at<double>(5,5)=dt4/4*s;
-    Q.at<double>(4,6)=Q.at<double>(5,7)=dt3/2*s;
-    Q.at<double>(6,4)=Q.at<double>(7,5)=dt3/2*s;
-    Q.at<double>(6,6)=Q.at<double>(7,7)=dt2*s;
+    for (int ti=0; ti<nT; ++ti){
+        int di = rowsol_[ti];
+        if (di>=0 && di<nD && cost_[std::size_t(ti)*N + di] < BIG) tr2det_[ti]=di;
+    }
+    return std::size_t(N)*N;
+}
 
-    kf.processNoiseCov = Q;
+template<class T>
+std::size_t BasicTracker<T>::assign_sparse(int nT,int nD)
+{
+    sparse_assign(nT, nD, edges_, tr2det_, sparse_ws_);
+    return edges_.size();
 }
 
-cv::KalmanFilter Tracker::create_kf(const Detection& d)
+template<class T>
+int BasicTracker<T>::assign_fast(int nT,int nD)
 {
-    cv::KalmanFilter kf(8,4,0,CV_64F);
+    const int nE = static_cast<int>(edges_.size());
+    int fast = 0;
+    auto commit = [&](const Edge& e){ tr2det_[e.row] = e.col; det2tr_[e.col] = e.row; ++fast; };
+    auto open   = [&](const Edge& e){ return tr2det_[e.row] == -1 && det2tr_[e.col] == -1; };
+
+    // ─── a. mutual best-IoU pairs above fast_iou ────────────────────
+    best_t_.assign(nT,-1); best_d_.assign(nD,-1);
+    for (int k=0;k<nE;++k) {
+        const Edge& e = edges_[k];
+        if (best_t_[e.row] < 0 || edge_iou_[k] > edge_iou_[best_t_[e.row]]) best_t_[e.row] = k;
+        if (best_d_[e.col] < 0 || edge_iou_[k] > edge_iou_[best_d_[e.col]]) best_d_[e.col] = k;
+    }
+    for (int ti=0;ti<nT;++ti) {
+        const int k = best_t_[ti];
+        if (k >= 0 && best_d_[edges_[k].col] == k && edge_iou_[k] >= fast_iou_) commit(edges_[k]);
+    }
+
+    // ─── b. pairs left with no competitor (exact) ───────────────────
+    deg_t_.assign(nT,0); deg_d_.assign(nD,0);
+    for (const auto& e : edges_) if (open(e)) { ++deg_t_[e.row]; ++deg_d_[e.col]; }
+    for (const auto& e : edges_)
+        if (deg_t_[e.row] == 1 && deg_d_[e.col] == 1 && open(e)) commit(e);
+    metrics_.add(metrics::FastPath, fast);
+    return fast;
+}
 
-    // F
-    kf.transitionMatrix = (cv::Mat_<double>(8,8) <<
-         1,0,1,0,0,0,0,0,
-         0,1,0,1,0,0,0,0,
-         0,0,1,0,0,0,0,0,
-         0,0,0,1,0,0,0,0,
-         0,0,0,0,1,0,1,0,
-         0,0,0,0,0,1,0,1,
-         0,0,0,0,0,0,1,0,
-         0,0,0,0,0,0,0,1);
+/**
+ * Degraded frames: the cascade's fast path, then the remaining pairs in
+ * cost order over the tracks the last associating frame matched.  Lost
+ * tracks wait for the next full frame and its solver.
+ */
+template<class T>
+void BasicTracker<T>::assign_partial(int nT,int nD)
+{
+    assign_fast(nT, nD);
+    order_.clear();
+    for (int k=0; k<static_cast<int>(edges_.size()); ++k) {
+        const Edge& e = edges_[k];
+        if (tracks_.time_since_update[e.row] == 0 && tr2det_[e.row] == -1 && det2tr_[e.col] == -1)
+            order_.push_back(k);
+    }
+    std::sort(order_.begin(), order_.end(), [&](int a, int b) {
+        return edges_[a].cost < edges_[b].cost || (edges_[a].cost == edges_[b].cost && a < b);
+    });
+    for (const int k : order_) {
+        const Edge& e = edges_[k];
+        if (tr2det_[e.row] == -1 && det2tr_[e.col] == -1) { tr2det_[e.row] = e.col; det2tr_[e.col] = e.row; }
+    }
+}
 
-    // H
-    kf.measurementMatrix = cv::Mat::zeros(4,8,CV_64F);
-    kf.measurementMatrix.at<double>(0,0)=1;
-    kf.measurementMatrix.at<double>(1,1)=1;
-    kf.measurementMatrix.at<double>(2,4)=1;
-    kf.measurementMatrix.at<double>(3,5)=1;
+template<class T>
+std::size_t BasicTracker<T>::assign_cascade(int nT,int nD)
+{
+    auto open = [&](const Edge& e){ return tr2det_[e.row] == -1 && det2tr_[e.col] == -1; };
+    assign_fast(nT, nD);
+
+    // ─── c. hungarian() on the residual, compacted ──────────────────
+    std::fill(best_t_.begin(), best_t_.end(), -1);      // now: residual index
+    std::fill(best_d_.begin(), best_d_.end(), -1);
+    res_rows_.clear(); res_cols_.clear();
+    for (const auto& e : edges_) if (open(e)) {
+        if (best_t_[e.row] < 0) { best_t_[e.row] = static_cast<int>(res_rows_.size()); res_rows_.push_back(e.row); }
+        if (best_d_[e.col] < 0) { best_d_[e.col] = static_cast<int>(res_cols_.size()); res_cols_.push_back(e.col); }
+    }
+    const int nr = static_cast<int>(res_rows_.size()), nc = static_cast<int>(res_cols_.size());
+    if (nr == 0) return 0;
+
+    const int N  = std::max(nr,nc);
+    const T BIG = T(1e9);
+    cost_.assign(std::size_t(N)*N, T(0));
+    for (int i=0;i<nr;++i) std::fill_n(&cost_[std::size_t(i)*N], nc, BIG);
+    for (const auto& e : edges_)
+        if (open(e)) cost_[std::size_t(best_t_[e.row])*N + best_d_[e.col]] = e.cost;
+
+    solve_dense(N, nr, res_rows_.data(), BIG);
+    for (int r=0; r<nr; ++r) {
+        const int c = rowsol_[r];
+        if (c < nc && cost_[std::size_t(r)*N + c] < BIG) tr2det_[res_rows_[r]] = res_cols_[c];
+    }
+    return std::size_t(N)*N;
+}
 
-    // noise / cov
-    kf.measurementNoiseCov = cv::Mat::eye(4,4,CV_64F) * 1e-2;
-    kf.errorCovPost        = cv::Mat::eye(8,8,CV_64F);
+// ───────────────── snapshot ─────────────────────────────────────────
+namespace {
 
-    kf.statePost = (cv::Mat_<double>(8,1) << d.x,d.y,0,0,d.w,d.h,0,0);
-    set_Q(kf,1.0);
+constexpr char          snapshot_magic[4] = {'T','R','K','S'};
+constexpr std::uint16_t snapshot_version  = 1;
+constexpr std::uint16_t snapshot_f32      = 1u << 0;
 
-    return kf;
+struct SnapshotHeader { char magic[4]; std::uint16_t version, flags; std::uint32_t tracks, max_tracks; };
+struct SnapshotParams
+{
+    double        max_dist, alpha, fast_iou, time;
+    std::int32_t  max_age, next_id;
+    std::uint32_t assigner, warm_start;
+};
+static_assert(sizeof(SnapshotHeader) == 16 && sizeof(SnapshotParams) == 48, "snapshot layout");
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#  error "tracker snapshots are little-endian; add byte swapping for this target"
+#endif
+
+template<class R>
+void get(std::istream& in, R& r)
+{
+    in.read(reinterpret_cast<char*>(&r), sizeof r);
+    if (std::size_t(in.gcount()) != sizeof r) throw std::runtime_error("truncated tracker snapshot");
 }
 
-// ───────────────── constructor ──────────────────────────────────────
-Tracker::Tracker(double md,int ma,double a)
-    : max_dist_(md), alpha_(a), max_age_(ma), next_id_(0) {}
+} // namespace
 
-// ───────────────── main step ────────────────────────────────────────
-std::vector<Label> Tracker::step(double ts,const vector<Detection>& dets)
+template<class T>
+void BasicTracker<T>::save(std::ostream& out) const
 {
-    // ─── 1. predict ────────────────────────────────────────────────
-    for (auto& tr : tracks_)
-    {
-        double dt = ts - tr.last_ts;
-        if (dt<=0) dt = 1e-6;
+    SnapshotHeader h{};
+    std::memcpy(h.magic, snapshot_magic, 4);
+    h.version = snapshot_version;
+    h.flags   = std::is_same_v<T,float> ? snapshot_f32 : 0;
+    h.tracks  = static_cast<std::uint32_t>(tracks_.size());
+    h.max_tracks = static_cast<std::uint32_t>(max_tracks_);
+    const SnapshotParams p{double(max_dist_), double(alpha_), double(fast_iou_), time_,
+                           max_age_, next_id_,
+                           static_cast<std::uint32_t>(assigner_), warm_start_ ? 1u : 0u};
+    out.write(reinterpret_cast<const char*>(&h), sizeof h);
+    out.write(reinterpret_cast<const char*>(&p), sizeof p);
+    tracks_.save(out);
+    if (!out) throw std::runtime_error("cannot write tracker snapshot");
+}
 
-        set_F(tr.kf,dt);
-        set_Q(tr.kf,dt);
-        cv::Mat p = tr.kf.predict();
+template<class T>
+void BasicTracker<T>::restore(std::istream& in)
+{
+    SnapshotHeader h; SnapshotParams p;
+    get(in, h);
+    if (std::memcmp(h.magic, snapshot_magic, 4) != 0)
+        throw std::runtime_error("not a tracker snapshot");
+    if (h.version != snapshot_version)
+        throw std::runtime_error("unsupported tracker snapshot version " + std::to_string(h.version));
+    if (((h.flags & snapshot_f32) != 0) != std::is_same_v<T,float>)
+        throw std::runtime_error(std::string("tracker snapshot was taken in ") +
+                                 (h.flags & snapshot_f32 ? "float" : "double") + " precision");
+    get(in, p);
+    if (p.assigner > static_cast<std::uint32_t>(Assigner::Cascade) ||
+        (h.max_tracks && h.tracks > h.max_tracks))
+        throw std::runtime_error("corrupt tracker snapshot");
+
+    BasicTrackStore<T> tracks;
+    if (h.max_tracks) tracks.reserve(h.max_tracks);
+    tracks.restore(in, h.tracks);
+
+    max_dist_   = T(p.max_dist);
+    alpha_      = T(p.alpha);
+    fast_iou_   = T(p.fast_iou);
+    time_       = p.time;
+    max_age_    = p.max_age;
+    next_id_    = p.next_id;
+    assigner_   = static_cast<Assigner>(p.assigner);
+    warm_start_ = p.warm_start != 0;
+    max_tracks_ = h.max_tracks;
+    tracks_     = std::move(tracks);
+}
 
-        tr.rect = (cv::Mat_<double>(4,1) <<
-                    p.at<double>(0),
-                    p.at<double>(1),
-                    p.at<double>(4),
-                    p.at<double>(5));
-        tr.age++;
-        tr.time_since_update++;
+template<class T>
+void BasicTracker<T>::set_track_limit(std::size_t max_tracks)
+{
+    if (max_tracks > std::numeric_limits<std::uint32_t>::max())
+        throw std::invalid_argument("track limit out of range");
+    max_tracks_ = max_tracks;
+    if (max_tracks) { tracks_.reserve(max_tracks); victims_.reserve(max_tracks); }
+}
+
+// Evict up to (size + spawns - cap) unmatched tracks, stalest first.  Runs
+// after correct(), so tr2det_ still covers the old tracks; it follows every
+// move so det2tr_ keeps pointing at the right track.  A copied tracker
+// (vector copies drop their spare capacity) reserves again here, once.
+template<class T>
+std::size_t BasicTracker<T>::make_room(int nT, std::size_t spawns)
+{
+    if (!max_tracks_) return 0;
+    if (tracks_.capacity() < max_tracks_) set_track_limit(max_tracks_);
+    if (tracks_.size() + spawns <= max_tracks_) return 0;
+    const std::size_t need = tracks_.size() + spawns - max_tracks_;
+
+    victims_.clear();
+    for (int ti=0; ti<nT; ++ti) if (tr2det_[ti] == -1) victims_.push_back(ti);
+    const auto& tsu = tracks_.time_since_update;
+    const auto& age = tracks_.age;
+    if (victims_.size() > need) {
+        std::nth_element(victims_.begin(), victims_.begin() + std::ptrdiff_t(need), victims_.end(),
+                         [&](int a, int b) {
+                             if (tsu[a] != tsu[b]) return tsu[a] > tsu[b];
+                             if (age[a] != age[b]) return age[a] < age[b];
+                             return a < b;
+                         });
+        victims_.resize(need);
     }
 
-    // ─── 2. build cost matrix ──────────────────────────────────────
-    const int nT = static_cast<int>(tracks_.size());
-    const int nD = static_cast<int>(dets.size());
-    const int N  = std::max(nT,nD);
-    const double BIG = 1e9;
+    // highest index first: the track moved into a hole is never a victim
+    std::sort(victims_.begin(), victims_.end(), std::greater<int>());
+    for (const int v : victims_) {
+        const int last = static_cast<int>(tracks_.size()) - 1;
+        tracks_.remove(std::size_t(v));
+        if (v != last) {
+            tr2det_[v] = tr2det_[last];
+            if (tr2det_[v] != -1) det2tr_[tr2det_[v]] = v;
+        }
+    }
+    return victims_.size();
+}
 
-    vector<vector<double>> C(N, vector<double>(N,BIG));
+// ───────────────── main step ────────────────────────────────────────
+namespace {
 
-    for (int ti=0; ti<nT; ++ti)
-        for (int di=0; di<nD; ++di)
-        {
-            double dist = centre_dist(dets[di], tracks_[ti]);
-            if (dist > max_dist_) continue;
+/** Adds the heap allocations made during its lifetime to `to`. */
+struct AllocScope
+{
+    explicit AllocScope(std::uint64_t& to) : to_(to), a0_(alloc::thread_count()) {}
+    ~AllocScope() { to_ += alloc::thread_count() - a0_; }
+    std::uint64_t& to_;
+    std::uint64_t  a0_;
+};
 
-            double j = iou(tracks_[ti], dets[di]);
-            if (j < 0.01)         continue;
+} // namespace
 
-            C[ti][di] = alpha_*(1.0-j) + (1.0-alpha_)*dist;
-        }
+template<class T>
+std::size_t BasicTracker<T>::step_into(double ts,const Detection* in,std::size_t n,Label* out,
+                                       StepMode mode)
+{
+    begin(ts, in, n, mode);
+    predict();
+    gate();
+    associate();
+    correct();
+    return finish(out);
+}
 
-    // pad zeros for dummy rows/cols
-    for (int i=nT;i<N;++i) std::fill(C[i].begin(), C[i].end(), 0.0);
-    for (int i=0;i<N;++i) for (int j=nD;j<N;++j) C[i][j]=0.0;
+template<class T>
+void BasicTracker<T>::begin(double ts, const Detection* in, std::size_t n, StepMode mode)
+{
+    if constexpr (metrics::enabled) step_t0_ = metrics::Clock::now();
+    step_allocs_ = 0;
+    AllocScope allocs(step_allocs_);
+    time_ = ts;
+    in_ = in; n_ = n;
+    mode_ = mode;
+
+    // the core works in T; a double tracker uses the caller's buffer as is
+    if constexpr (std::is_same_v<T,double>) frame_ = in;
+    else {
+        dets_.resize(n);
+        for (std::size_t i=0; i<n; ++i) dets_[i] = {T(in[i].x), T(in[i].y), T(in[i].w), T(in[i].h)};
+        frame_ = dets_.data();
+    }
+    edges_.clear(); edge_iou_.clear();
+}
 
-    // ─── 3. Hungarian assign ───────────────────────────────────────
-    vector<int> assign; double tot = 0.0;
-    hungarian(C,assign,tot);
+template<class T>
+typename BasicTracker<T>::View BasicTracker<T>::view()
+{
+    return {tracks_, time_, frame_, n_, gate::Gate<T>{max_dist_, T(0.01), alpha_},
+            edges_, edge_iou_, tr2det_};
+}
 
-    vector<int> tr2det(nT,-1), det2tr(nD,-1);
-    for (int ti=0; ti<nT; ++ti){
-        int di = assign[ti];
-        if (di>=0 && di<nD && C[ti][di] < BIG){
-            tr2det[ti]=di; det2tr[di]=ti;
-        }
+// ─── 1. predict (one batched pass over the SoA store) ─────────────
+template<class T>
+void BasicTracker<T>::predict()
+{
+    AllocScope allocs(step_allocs_);
+    metrics::Lap lap(metrics_);
+    // a degraded frame is no miss.  Coasting leaves the filter alone: the
+    // next associating frame predicts each track over the whole gap from
+    // its last update, which is the coasted motion
+    if (mode_ == StepMode::Coast) tracks_.age_all(false);
+    else                          tracks_.predict(time_, mode_ == StepMode::Full);
+    lap.mark(metrics::Predict);
+}
+
+// ─── 2. gate & score candidate pairs ──────────────────────────────
+template<class T>
+void BasicTracker<T>::gate()
+{
+    if (mode_ == StepMode::Coast) return;
+    AllocScope allocs(step_allocs_);
+    metrics::Lap lap(metrics_);
+    const int nT = static_cast<int>(tracks_.size());
+    const int nD = static_cast<int>(n_);
+
+    const bool parallel = std::size_t(nT) * std::size_t(nD) >= gate_min_pairs_ && pool_.threads() > 1;
+    if (assigner_ == Assigner::Dense) {                      // every pair
+        if (parallel) gate_parallel(frame_,nD,false);
+        else          gate_all(frame_,0,nD,cand_,edges_,edge_iou_);
     }
+    else gate_grid(frame_,nD,parallel);                      // cell list
+    lap.mark(metrics::Gate);
+}
 
-    // ─── 4. update matched ─────────────────────────────────────────
-    for (int ti=0; ti<nT; ++ti){
-        int di = tr2det[ti];
-        if (di!=-1){
-            cv::Mat corr = tracks_[ti].kf.correct(det2meas(dets[di]));
-            tracks_[ti].rect = (cv::Mat_<double>(4,1) <<
-                                 corr.at<double>(0),
-                                 corr.at<double>(1),
-                                 corr.at<double>(4),
-                                 corr.at<double>(5));
-            tracks_[ti].last_ts = ts;
-            tracks_[ti].time_since_update = 0;
-        }
+// ─── 3. assign ─────────────────────────────────────────────────────
+template<class T>
+void BasicTracker<T>::associate()
+{
+    AllocScope allocs(step_allocs_);
+    metrics::Lap lap(metrics_);
+    const int nT = static_cast<int>(tracks_.size());
+    const int nD = static_cast<int>(n_);
+
+    tr2det_.assign(nT,-1); det2tr_.assign(nD,-1);
+    cells_ = 0;
+    if (mode_ == StepMode::Partial) assign_partial(nT,nD);
+    else if (mode_ == StepMode::Full) switch (assigner_) {
+    case Assigner::Dense:   cells_ = assign_dense  (nT,nD); break;
+    case Assigner::Sparse:  cells_ = assign_sparse (nT,nD); break;
+    case Assigner::Cascade: cells_ = assign_cascade(nT,nD); break;
     }
 
-    // ─── 5. add new tracks for unmatched detections ────────────────
-    for (int di=0; di<nD; ++di) if (det2tr[di]==-1)
-    {
-        Track tr;
-        tr.id    = next_id_++;
-        tr.kf    = create_kf(dets[di]);
-        tr.rect  = det2meas(dets[di]).clone();
-        tr.last_ts = ts;
-        tracks_.push_back(std::move(tr));
+    matched_ = 0;
+    for (int ti=0; ti<nT; ++ti)
+        if (tr2det_[ti] != -1) { det2tr_[tr2det_[ti]] = ti; ++matched_; }
+    lap.mark(metrics::Assign);
+}
 
-        det2tr[di] = static_cast<int>(tracks_.size()) - 1; // index of new track
+// ─── 4. update matched (one batched pass) ──────────────────────────
+template<class T>
+void BasicTracker<T>::correct()
+{
+    if (mode_ == StepMode::Coast) return;
+    AllocScope allocs(step_allocs_);
+    metrics::Lap lap(metrics_);
+    tracks_.correct(time_, tr2det_.data(), frame_);
+    lap.mark(metrics::Correct);
+}
+
+template<class T>
+std::size_t BasicTracker<T>::finish(Label* out)
+{
+    std::size_t nl = 0, evicted = 0, spawned = 0, before = 0;
+    {
+    AllocScope allocs(step_allocs_);
+    metrics::Lap lap(metrics_);
+    const int nT = static_cast<int>(tr2det_.size());
+    const int nD = static_cast<int>(n_);
+    const double ts = time_;
+
+    // ─── 5. add new tracks for unmatched detections (full frames) ──
+    if (mode_ == StepMode::Full) {
+        evicted = make_room(nT, std::size_t(nD - matched_));
+        for (int di=0; di<nD; ++di) if (det2tr_[di]==-1)
+        {
+            if (max_tracks_ && tracks_.size() >= max_tracks_) break;   // at the cap
+            tracks_.push(next_id_++, ts, frame_[di]);
+            det2tr_[di] = static_cast<int>(tracks_.size()) - 1; // index of new track
+            ++spawned;
+        }
     }
+    lap.mark(metrics::Spawn);
 
     // ─── 6. prepare labels (RAW rectangles) ────────────────────────
     labels_.clear();
     for (int di=0; di<nD; ++di)
-        if (det2tr[di] != -1)         // actually associated
-            labels_.push_back( { tracks_[det2tr[di]].id, dets[di] } );
-
-    // ─── 7. cull stale tracks ──────────────────────────────────────
-    tracks_.erase( remove_if(tracks_.begin(), tracks_.end(),
-                  [&](const Track& t){ return t.time_since_update > max_age_; }),
-                  tracks_.end() );
+        if (det2tr_[di] != -1) {      // actually associated
+            const Label l{ tracks_.id[det2tr_[di]], in_[di] };
+            if (out) out[nl] = l; else labels_.push_back(l);
+            ++nl;
+        }
+    lap.mark(metrics::Labels);
 
-    return labels_;
+    // ─── 7. cull stale tracks (swap-and-pop) ───────────────────────
+    before = tracks_.size();
+    tracks_.cull(max_age_);
+    lap.mark(metrics::Cull);
+    }
+    metrics::Lap(metrics_, step_t0_).total(metrics::Step);
+
+    metrics_.add(metrics::Frames,      1);
+    metrics_.add(metrics::Detections,  n_);
+    metrics_.add(metrics::Matches,     matched_);
+    metrics_.add(metrics::Spawned,     spawned);
+    metrics_.add(metrics::Evicted,     evicted);
+    if (mode_ == StepMode::Full)
+        metrics_.add(metrics::Refused, std::size_t(n_ - std::size_t(matched_)) - spawned);
+    metrics_.add(metrics::Coasted,     mode_ == StepMode::Coast);
+    metrics_.add(metrics::Partial,     mode_ == StepMode::Partial);
+    metrics_.add(metrics::Culled,      before - tracks_.size());
+    metrics_.add(metrics::Candidates,  edges_.size());
+    metrics_.add(metrics::AssignCells, cells_);
+    metrics_.add(metrics::Allocations, step_allocs_);
+    metrics_.tracks_alive = static_cast<std::int64_t>(tracks_.size());
+    in_ = nullptr; frame_ = nullptr;
+
+    return nl;
 }
+
+template class BasicTracker<float>;
+template class BasicTracker<double>;
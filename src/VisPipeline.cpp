@@ -0,0 +1,119 @@
+#include "VisPipeline.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+VisOptions VisOptions::from(const Config& cfg)
+{
+    VisOptions o;
+    cfg.read("tracker", "vis-dir",     o.dir);
+    cfg.read("tracker", "vis",         o.mode);
+    cfg.read("tracker", "vis-every",   o.every);
+    cfg.read("tracker", "vis-threads", o.threads);
+    cfg.read("tracker", "vis-queue",   o.queue);
+    return o;
+}
+
+VisPipeline::VisPipeline(const VisOptions& opt) : opt_(opt)
+{
+    if (opt_.mode == "off") return;
+    opt_.every   = std::max(1, opt_.every);
+    opt_.queue   = std::max(1, opt_.queue);
+    opt_.threads = std::max(1, opt_.threads);
+
+    if (opt_.mode == "video") {
+        const std::string fn = opt_.dir + "/tracks.mp4";
+        if (!video_.open(fn, cv::VideoWriter::fourcc('m','p','4','v'), opt_.fps,
+                          cv::Size(opt_.width, opt_.height)))
+            throw std::runtime_error("cannot open video " + fn);
+    }
+    for (int i=0; i<opt_.threads; ++i) workers_.emplace_back(&VisPipeline::worker, this);
+}
+
+VisPipeline::~VisPipeline() { finish(); }
+
+void VisPipeline::submit(int idx, const TrackStore& tracks)
+{
+    if (workers_.empty() || idx % opt_.every != 0) return;
+
+    std::unique_lock<std::mutex> lk(m_);
+    not_full_.wait(lk, [&]{ return static_cast<int>(jobs_.size()) < opt_.queue; });
+
+    // png names keep the frame index; video frames are numbered densely
+    Job job{opt_.mode == "png" ? idx : idx / opt_.every, {}};
+    if (!spare_.empty()) { job.boxes = std::move(spare_.back()); spare_.pop_back(); }
+    lk.unlock();
+
+    job.boxes.clear();
+    for (std::size_t i=0; i<tracks.size(); ++i) {
+        const auto r = tracks.rect(i);
+        job.boxes.push_back({tracks.id[i], r[0], r[1], r[2], r[3]});
+    }
+
+    lk.lock();
+    jobs_.push_back(std::move(job));
+    lk.unlock();
+    not_empty_.notify_one();
+}
+
+void VisPipeline::finish()
+{
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        stop_ = true;
+    }
+    not_empty_.notify_all();
+    for (auto& t : workers_) t.join();
+    workers_.clear();
+    if (video_.isOpened()) video_.release();
+}
+
+void VisPipeline::worker()
+{
+    cv::Mat img;
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lk(m_);
+            not_empty_.wait(lk, [&]{ return stop_ || !jobs_.empty(); });
+            if (jobs_.empty()) return;                 // stop_ and drained
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        not_full_.notify_one();
+
+        render(job, img);
+        if (opt_.mode == "video") write_video(job.idx, std::move(img));
+        else {
+            std::ostringstream fn;
+            fn << opt_.dir << "/frame_" << std::setw(4) << std::setfill('0') << job.idx << ".png";
+            cv::imwrite(fn.str(), img);
+        }
+
+        std::lock_guard<std::mutex> lk(m_);
+        spare_.push_back(std::move(job.boxes));
+    }
+}
+
+void VisPipeline::render(const Job& job, cv::Mat& img) const
+{
+    const int W = opt_.width, H = opt_.height;
+    img = cv::Mat(H,W,CV_8UC3, cv::Scalar(35,35,35));
+    for (auto& t : job.boxes) {
+        int x=int(t.x*W), y=int(t.y*H);
+        int w=int(t.w*W), h=int(t.h*H);
+        cv::rectangle(img,{x,y,w,h}, {0,255,0},2);
+        cv::putText(img,std::to_string(t.id),{x,y-5},
+                    cv::FONT_HERSHEY_SIMPLEX,0.5,{0,255,255},1);
+    }
+}
+
+void VisPipeline::write_video(int idx, cv::Mat&& img)
+{
+    std::lock_guard<std::mutex> lk(vm_);
+    ready_.emplace(idx, std::move(img));
+    for (auto it = ready_.begin(); it != ready_.end() && it->first == next_write_;
+         it = ready_.erase(it), ++next_write_)
+        video_.write(it->second);
+}
@@ -0,0 +1,85 @@
+#include "WorkPool.hpp"
+#include <algorithm>
+
+WorkPool::WorkPool(unsigned threads)
+    : threads_(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+WorkPool& WorkPool::operator=(const WorkPool& o)
+{
+    if (this != &o) { stop(); threads_ = o.threads_; }
+    return *this;
+}
+
+WorkPool::~WorkPool() { stop(); }
+
+void WorkPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& t : helpers_) t.join();
+    helpers_.clear();
+    stop_ = false;
+}
+
+void WorkPool::drain()
+{
+    for (std::size_t i; (i = next_.fetch_add(1, std::memory_order_relaxed)) < parts_; ) {
+        try { fn_(ctx_, i); }
+        catch (...) {
+            std::lock_guard<std::mutex> lk(m_);
+            if (!err_) err_ = std::current_exception();
+        }
+    }
+}
+
+void WorkPool::worker()
+{
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(m_);
+            work_cv_.wait(lk, [&]{ return stop_ || gen_ != seen; });
+            if (stop_) return;
+            seen = gen_;
+        }
+        drain();
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            ++done_;
+        }
+        done_cv_.notify_one();
+    }
+}
+
+void WorkPool::run_impl(std::size_t parts, Fn fn, void* ctx)
+{
+    if (threads_ <= 1 || parts <= 1) {
+        for (std::size_t i=0; i<parts; ++i) fn(ctx, i);
+        return;
+    }
+    if (helpers_.empty())
+        for (unsigned i=1; i<threads_; ++i) helpers_.emplace_back(&WorkPool::worker, this);
+
+    // every helper takes each generation exactly once, so the job fields
+    // are not touched again until all of them have reported back
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        fn_ = fn; ctx_ = ctx; parts_ = parts;
+        next_.store(0, std::memory_order_relaxed);
+        done_ = 0;
+        ++gen_;
+    }
+    work_cv_.notify_all();
+    drain();
+
+    std::exception_ptr err;
+    {
+        std::unique_lock<std::mutex> lk(m_);
+        done_cv_.wait(lk, [&]{ return done_ == helpers_.size(); });
+        std::swap(err, err_);
+    }
+    if (err) std::rethrow_exception(err);
+}
@@ -0,0 +1,31 @@
+#include "alloc_count.hpp"
+#ifdef TRACKER_COUNT_ALLOCS
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local std::uint64_t t_allocs = 0;
+
+void* counted(std::size_t n, std::size_t align)
+{
+    ++t_allocs;
+    if (n == 0) n = 1;
+    void* p = align <= alignof(std::max_align_t)
+            ? std::malloc(n)
+            : std::aligned_alloc(align, (n + align - 1) / align * align);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+} // namespace
+
+std::uint64_t alloc::thread_count() { return t_allocs; }
+
+// the array and nothrow forms of libstdc++ forward to these
+void* operator new(std::size_t n)                       { return counted(n, 0); }
+void* operator new(std::size_t n, std::align_val_t a)   { return counted(n, std::size_t(a)); }
+void  operator delete(void* p) noexcept                         { std::free(p); }
+void  operator delete(void* p, std::size_t) noexcept            { std::free(p); }
+void  operator delete(void* p, std::align_val_t) noexcept       { std::free(p); }
+void  operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
@@ -0,0 +1,277 @@
+// tracker-bench – Google Benchmark suite for the tracking hot path.
+//
+//   tracker-bench --benchmark_format=json                  # JSON on stdout
+//   tracker-bench --benchmark_out=bench.json --benchmark_out_format=json
+//
+// Scenes come from SceneGenerator (the generate_input.py motion model).
+// Above 100 objects box sizes and the gate shrink with 1/sqrt(N), so the
+// overlap per object stays that of the 100-object test scene.
+#include "Tracker.hpp"
+#include "SceneGen.hpp"
+#include "hungarian.hpp"
+#include "kalman.hpp"
+#include "alloc_count.hpp"
+#include "sparse_assign.hpp"
+#include "gate_kernels.hpp"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr double BIG = 1e9;
+
+/** Scale of boxes / gate for an N-object scene, relative to N = 100. */
+double density_scale(int n) { return n <= 100 ? 1.0 : std::sqrt(100.0 / n); }
+
+SceneParams scene(int n, int frames)
+{
+    SceneParams p;
+    p.frames      = frames;
+    p.min_objects = p.max_objects = n;
+    p.min_life    = 6;  p.max_life = 25;
+    p.min_size   *= density_scale(n);
+    p.max_size   *= density_scale(n);
+    p.wind_max    = 0.08;
+    p.rot_sigma   = 0.02; p.scale_sigma = 0.02;
+    p.drop_prob   = 0.10;
+    return p;
+}
+
+std::vector<Frame> make_frames(int n, int frames)
+{
+    SceneGenerator gen(scene(n, frames));
+    std::vector<Frame> out(frames);
+    for (auto& f : out) gen.next(f);
+    return out;
+}
+
+template<class T>
+std::vector<BasicDetection<T>> narrow(const std::vector<Detection>& dets)
+{
+    std::vector<BasicDetection<T>> out;
+    for (const auto& d : dets) out.push_back({T(d.x), T(d.y), T(d.w), T(d.h)});
+    return out;
+}
+
+/** n x n costs in [0,1); a (1 - density) share of cells is inadmissible. */
+void random_problem(int n, double density, std::vector<std::vector<double>>& C,
+                    std::vector<SparseEdge>& edges)
+{
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    C.assign(n, std::vector<double>(n, BIG));
+    edges.clear();
+    for (int i=0; i<n; ++i)
+        for (int j=0; j<n; ++j)
+            if (u(rng) < density) { C[i][j] = u(rng); edges.push_back({i, j, C[i][j]}); }
+}
+
+// ─── association solvers ───────────────────────────────────────────
+// args: N, density in percent
+void BM_Hungarian(benchmark::State& st)
+{
+    const int n = int(st.range(0));
+    std::vector<std::vector<double>> C; std::vector<SparseEdge> edges;
+    random_problem(n, st.range(1) / 100.0, C, edges);
+    std::vector<int> sol; double tot;
+    for (auto _ : st) {
+        hungarian(C, sol, tot);
+        benchmark::DoNotOptimize(sol.data());
+    }
+    st.counters["edges"] = double(edges.size());
+}
+BENCHMARK(BM_Hungarian)->ArgsProduct({{16, 64, 256, 1024}, {2, 10, 100}})
+                       ->Unit(benchmark::kMicrosecond);
+
+// consecutive "frames": admissible costs jittered by up to 2%, each solved
+// cold or from the previous solve's row potentials.  args: N, warm
+void BM_HungarianWarm(benchmark::State& st)
+{
+    const int n = int(st.range(0));
+    const bool warm = st.range(1) != 0;
+    std::vector<std::vector<double>> C; std::vector<SparseEdge> edges;
+    random_problem(n, 0.10, C, edges);
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> jitter(0.98, 1.02);
+    std::vector<std::vector<double>> frames(8);
+    for (auto& f : frames) {
+        f.resize(std::size_t(n)*n);
+        for (int i=0; i<n; ++i)
+            for (int j=0; j<n; ++j) f[std::size_t(i)*n + j] = C[i][j] < BIG ? C[i][j] * jitter(rng) : BIG;
+    }
+    std::vector<int> sol; double tot; HungarianWs ws;
+    std::vector<double> u(n, 0.0); std::vector<char> known(n, 1);
+    hungarian(frames[0].data(), n, sol, tot, ws);
+    for (int i=0; i<n; ++i) u[i] = ws.u[i+1];
+    std::size_t k = 0;
+    for (auto _ : st) {
+        const double* f = frames[++k % frames.size()].data();
+        if (warm) hungarian_warm(f, n, u.data(), known.data(), BIG, sol, tot, ws);
+        else      hungarian(f, n, sol, tot, ws);
+        benchmark::DoNotOptimize(sol.data());
+    }
+}
+BENCHMARK(BM_HungarianWarm)->ArgsProduct({{64, 256, 1024}, {0, 1}})
+                           ->ArgNames({"n", "warm"})
+                           ->Unit(benchmark::kMicrosecond);
+
+void BM_SparseAssign(benchmark::State& st)
+{
+    const int n = int(st.range(0));
+    std::vector<std::vector<double>> C; std::vector<SparseEdge> edges;
+    random_problem(n, st.range(1) / 100.0, C, edges);
+    std::vector<int> sol; SparseAssignWs ws;
+    for (auto _ : st) {
+        sparse_assign(n, n, edges, sol, ws);
+        benchmark::DoNotOptimize(sol.data());
+    }
+    st.counters["edges"] = double(edges.size());
+}
+BENCHMARK(BM_SparseAssign)->ArgsProduct({{16, 64, 256, 1024}, {2, 10, 100}})
+                          ->Unit(benchmark::kMicrosecond);
+
+// ─── gating metrics, all tracks x all detections ───────────────────
+// Benchmarks templated on T run for both core precisions.
+template<class T>
+void BM_CentreDistIou(benchmark::State& st)
+{
+    const int n = int(st.range(0));
+    const auto dets = narrow<T>(make_frames(n, 1)[0].dets);
+    std::vector<std::array<T,4>> rects;
+    for (const auto& d : dets) rects.push_back({d.x + T(0.003), d.y - T(0.002), d.w, d.h});
+    for (auto _ : st) {
+        T acc = 0;
+        for (const auto& r : rects)
+            for (const auto& d : dets)
+                acc += BasicTracker<T>::centre_dist(d, r) + BasicTracker<T>::iou(r, d);
+        benchmark::DoNotOptimize(acc);
+    }
+    st.SetItemsProcessed(st.iterations() * int64_t(rects.size()) * int64_t(dets.size()));
+}
+BENCHMARK_TEMPLATE(BM_CentreDistIou, double)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_CentreDistIou, float)->Arg(10)->Arg(100)->Arg(1000);
+
+// same pairs through gate::candidates(), one detection against all boxes
+// at a time; first checked against the pair-by-pair loop, so a kernel
+// that gates or scores differently fails instead of timing
+template<class T>
+void BM_GateKernel(benchmark::State& st)
+{
+    const int n = int(st.range(0));
+    const auto dets = narrow<T>(make_frames(n, 1)[0].dets);
+    std::vector<T> x, y, w, h;
+    for (const auto& d : dets) { x.push_back(d.x + T(0.003)); y.push_back(d.y - T(0.002)); w.push_back(d.w); h.push_back(d.h); }
+    const gate::Boxes<T> boxes{x.data(), y.data(), w.data(), h.data(), x.size()};
+    const gate::Gate<T>  g{T(0.10 * density_scale(n)), T(0.01), T(0.7)};
+
+    gate::Candidates<T> cand, ref;
+    for (const auto& d : dets) {
+        cand.clear(); ref.clear();
+        gate::candidates(d, boxes, g, cand);
+        for (std::size_t i=0; i<boxes.n; ++i) {
+            const T dist = gate::centre_dist(d, x[i], y[i], w[i], h[i]);
+            const T j    = gate::iou(x[i], y[i], w[i], h[i], d);
+            if (dist > g.max_dist || j < g.min_iou) continue;
+            ref.index.push_back(int(i));
+            ref.cost.push_back(g.alpha*(T(1)-j) + (T(1)-g.alpha)*dist);
+            ref.iou.push_back(j);
+        }
+        if (cand.index != ref.index || cand.cost != ref.cost || cand.iou != ref.iou) {
+            st.SkipWithError("gate::candidates differs from the scalar metrics");
+            return;
+        }
+    }
+    std::size_t kept = 0;
+    for (auto _ : st) {
+        kept = 0;
+        for (const auto& d : dets) { cand.clear(); kept += gate::candidates(d, boxes, g, cand); }
+        benchmark::DoNotOptimize(cand.index.data());
+    }
+    st.SetItemsProcessed(st.iterations() * int64_t(boxes.n) * int64_t(dets.size()));
+    st.counters["candidates"] = double(kept);
+}
+BENCHMARK_TEMPLATE(BM_GateKernel, double)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_GateKernel, float)->Arg(10)->Arg(100)->Arg(1000);
+
+// ─── Kalman filter ─────────────────────────────────────────────────
+void BM_KalmanInitPredictCorrect(benchmark::State& st)
+{
+    ConstVelKF kf;
+    for (auto _ : st) {
+        kf.init(0.4, 0.5, 0.1, 0.1);
+        kf.predict(0.033);
+        kf.correct(0.41, 0.5, 0.1, 0.1);
+        benchmark::DoNotOptimize(kf.ax);
+    }
+}
+BENCHMARK(BM_KalmanInitPredictCorrect);
+
+// batched predict + correct over an N-track store
+template<class T>
+void BM_TrackStorePredictCorrect(benchmark::State& st)
+{
+    const int n = int(st.range(0));
+    const auto dets = narrow<T>(make_frames(n, 1)[0].dets);
+    BasicTrackStore<T> store;
+    for (std::size_t i=0; i<dets.size(); ++i) store.push(int(i), 0.0, dets[i]);
+    std::vector<int> tr2det(store.size());
+    for (std::size_t i=0; i<tr2det.size(); ++i) tr2det[i] = (i % 8) ? int(i) : -1;
+    double ts = 0.0;
+    for (auto _ : st) {
+        ts += 0.033;
+        store.predict(ts);
+        store.correct(ts, tr2det.data(), dets.data());
+    }
+    st.SetItemsProcessed(st.iterations() * int64_t(store.size()));
+}
+BENCHMARK_TEMPLATE(BM_TrackStorePredictCorrect, double)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_TrackStorePredictCorrect, float)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+// ─── full step ─────────────────────────────────────────────────────
+// args: N objects, assigner (0 dense, 1 sparse, 2 cascade)
+template<class T>
+void BM_TrackerStep(benchmark::State& st)
+{
+    const int n = int(st.range(0));
+    const Assigner assigner[] = {Assigner::Dense, Assigner::Sparse, Assigner::Cascade};
+    const std::vector<Frame> frames = make_frames(n, 64);
+    const double gate = 0.10 * density_scale(n);
+
+    // the scene loops with its clock running on; one pass first as warm-up
+    const double period = frames.back().ts - frames.front().ts + 0.035;
+    BasicTracker<T> tracker(gate, 5, 0.7, assigner[st.range(1)]);
+    for (const Frame& f : frames) tracker.step(f.ts, f.dets.data(), f.dets.size());
+    std::size_t k = 0;
+    double offset = period;
+    int64_t dets = 0;
+    const std::uint64_t allocs0 = alloc::thread_count();
+    for (auto _ : st) {
+        if (k == frames.size()) { k = 0; offset += period; }
+        const Frame& f = frames[k++];
+        const auto& labels = tracker.step(f.ts + offset, f.dets.data(), f.dets.size());
+        benchmark::DoNotOptimize(labels.data());
+        dets += int64_t(f.dets.size());
+    }
+    st.SetItemsProcessed(dets);
+    st.counters["tracks"] = double(tracker.tracks().size());
+    const auto& m = tracker.metrics().counter;
+    if (assigner[st.range(1)] == Assigner::Cascade && m[metrics::Matches])
+        st.counters["fast_share"] = double(m[metrics::FastPath]) / double(m[metrics::Matches]);
+    if (alloc::enabled)
+        st.counters["allocs_per_step"] =
+            benchmark::Counter(double(alloc::thread_count() - allocs0), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK_TEMPLATE(BM_TrackerStep, double)->ArgsProduct({{10, 100, 1000}, {0, 2}})
+                                          ->ArgsProduct({{10, 100, 1000, 10000}, {1}})
+                                          ->ArgNames({"objects", "assigner"})
+                                          ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_TrackerStep, float)->ArgsProduct({{10, 100, 1000}, {0, 2}})
+                                         ->ArgsProduct({{10, 100, 1000, 10000}, {1}})
+                                         ->ArgNames({"objects", "assigner"})
+                                         ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
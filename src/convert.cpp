@@ -0,0 +1,129 @@
+// tracking-convert – translate frame / label streams between JSON and the
+// binary formats in BinaryFormat.hpp and QuantLabels.hpp.  Binary inputs
+// become JSON and JSON inputs become binary; the kind (detections vs
+// tracks) and the presence of per-frame stream ids are detected.
+#include "FrameIO.hpp"
+#include "BinaryFormat.hpp"
+#include "QuantLabels.hpp"
+#include <nlohmann/json.hpp>
+#include <CLI/CLI.hpp>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <utility>
+
+namespace {
+
+void convert_binary(const std::string& in, bin::Kind kind, std::ostream& out)
+{
+    if (kind == bin::Kind::Frames) {
+        BinaryFrameReader reader(in);
+        JsonFrameWriter   writer(out, reader.streams());
+        FrameView v;
+        while (reader.next_view(v)) writer.write_dets(v.ts, v.dets, v.n, v.stream);
+        writer.finish();
+    } else if (kind == bin::Kind::Labels) {
+        BinaryLabelReader reader(in);
+        JsonFrameWriter   writer(out, reader.streams());
+        double ts; std::uint32_t stream; std::vector<Label> labels;
+        while (reader.next(ts, labels, &stream)) writer.write_stream(stream, ts, labels);
+        writer.finish();
+    } else {
+        QuantLabelReader reader(in);
+        JsonFrameWriter  writer(out, reader.streams());
+        double ts; std::uint32_t stream; std::vector<Label> labels;
+        while (reader.next(ts, labels, &stream)) writer.write_stream(stream, ts, labels);
+        writer.finish();
+    }
+}
+
+/** How label streams are packed when JSON becomes binary. */
+struct LabelFormat { bool f32 = false, q16 = false; bin::Codec codec = bin::Codec::None; };
+
+std::unique_ptr<LabelSink> make_labels(std::ostream& out, const LabelFormat& fmt, bool streams)
+{
+    if (fmt.q16) return std::make_unique<QuantLabelWriter>(out, streams, fmt.codec);
+    return std::make_unique<BinaryLabelWriter>(out, fmt.f32, streams);
+}
+
+void convert_json(const std::string& in, std::ostream& out, const LabelFormat& fmt)
+{
+    std::ifstream f(in);
+    if (!f) throw std::runtime_error("cannot open " + in);
+    JsonObjectStream objs(f);
+
+    // the first frame that has "detections" or "tracks" decides the kind;
+    // frames before it (empty label frames) are held back until then.  The
+    // very first frame decides whether stream ids are recorded.
+    std::unique_ptr<BinaryFrameWriter> frames;
+    std::unique_ptr<LabelSink>         labels;
+    std::vector<std::pair<double,std::uint32_t>> pending;
+    bool first = true, streams = false;
+    std::vector<Detection> dets;
+    std::vector<Label>     lbls;
+
+    auto flush_pending = [&]{
+        for (const auto& [ts, stream] : pending) {
+            if (frames) frames->write(ts, nullptr, 0, stream);
+            else        labels->write_stream(stream, ts, {});
+        }
+        pending.clear();
+    };
+
+    std::string text;
+    while (objs.next(text)) {
+        const auto j  = nlohmann::json::parse(text);
+        const double ts = parse_iso(j.at("timestamp").get_ref<const std::string&>());
+        const std::uint32_t stream = j.value("stream", 0u);
+        if (first) { streams = j.contains("stream"); first = false; }
+        if (!frames && !labels) {
+            if      (j.contains("detections")) frames = std::make_unique<BinaryFrameWriter>(out, fmt.f32, streams);
+            else if (j.contains("tracks"))     labels = make_labels(out, fmt, streams);
+            else { pending.push_back({ts, stream}); continue; }
+            flush_pending();
+        }
+        if (frames) {
+            dets.clear();
+            for (auto& d : j.value("detections", nlohmann::json::array()))
+                dets.push_back({d["x"], d["y"], d["w"], d["h"]});
+            frames->write(ts, dets.data(), dets.size(), stream);
+        } else {
+            lbls.clear();
+            for (auto& t : j.value("tracks", nlohmann::json::array()))
+                lbls.push_back({t["id"], {t["x"], t["y"], t["w"], t["h"]}});
+            labels->write_stream(stream, ts, lbls);
+        }
+    }
+    if (!frames && !labels && !pending.empty()) {       // only empty label frames
+        labels = make_labels(out, fmt, streams);
+        flush_pending();
+    }
+    if (labels) labels->finish();
+}
+
+} // namespace
+
+int main(int argc,char** argv)
+{
+    std::string in, out, compress = "none";
+    LabelFormat fmt;
+
+    CLI::App app{"tracking-convert"};
+    app.add_option("input",  in,  "JSON or binary frame / label stream")->required();
+    app.add_option("output", out, "converted file")->required();
+    app.add_flag  ("--f32",  fmt.f32, "pack coordinates as float32 (JSON -> binary)");
+    app.add_flag  ("--q16",  fmt.q16, "labels: 16-bit coordinates with per-track deltas (TRKQ)");
+    app.add_option("--compress", compress, "--q16: block compression, none | zstd | lz4")
+        ->check(CLI::IsMember({"none","zstd","lz4"}));
+    CLI11_PARSE(app,argc,argv);
+
+    try {
+        fmt.codec = bin::codec_from(compress);
+        std::ofstream fout(out, std::ios::binary);
+        const bin::Kind kind = bin::sniff_file(in);
+        if (kind == bin::Kind::None) convert_json(in, fout, fmt);
+        else                         convert_binary(in, kind, fout);
+    }
+    catch (const std::exception& e) { std::cerr << e.what() << "\n"; return 1; }
+    return 0;
+}
@@ -0,0 +1,222 @@
+#include "gate_kernels.hpp"
+#include <cstdint>
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#  include <arm_neon.h>
+#  define GATE_NEON 1
+#endif
+
+namespace gate {
+namespace {
+
+/**
+ * Screening limits, widened by a relative 1e-4: the vector screen squares
+ * the distance instead of calling hypot(), so it must never reject a pair
+ * the exact test would keep.  Survivors are rechecked exactly.
+ */
+template<class T>
+struct Screen
+{
+    T cx, cy;            // detection centre
+    T dist2;             // widened max_dist^2
+    T min_iou;           // lowered min_iou
+
+    Screen(const BasicDetection<T>& d, const Gate<T>& g)
+        : cx(d.x + d.w * T(0.5)), cy(d.y + d.h * T(0.5)),
+          dist2(g.max_dist * g.max_dist * T(1.0001)),
+          min_iou(g.min_iou - std::fabs(g.min_iou) * T(1e-4)) {}
+};
+
+/** The exact pair test; appends when box i passes. */
+template<class T>
+inline void exact(const BasicDetection<T>& d, const Boxes<T>& b, const Gate<T>& g,
+                  std::size_t i, Candidates<T>& out)
+{
+    const T dist = centre_dist(d, b.x[i], b.y[i], b.w[i], b.h[i]);
+    if (dist > g.max_dist) return;
+
+    const T j = iou(b.x[i], b.y[i], b.w[i], b.h[i], d);
+    if (j < g.min_iou)     return;
+
+    out.index.push_back(static_cast<int>(i));
+    out.cost.push_back(g.alpha*(T(1)-j) + (T(1)-g.alpha)*dist);
+    out.iou.push_back(j);
+}
+
+template<class T>
+void screen_scalar(const BasicDetection<T>& d, const Boxes<T>& b, const Gate<T>& g,
+                   const Screen<T>& s, std::size_t i0, Candidates<T>& out)
+{
+    for (std::size_t i=i0; i<b.n; ++i) {
+        const T dx = s.cx - (b.x[i] + b.w[i] * T(0.5)),
+                dy = s.cy - (b.y[i] + b.h[i] * T(0.5));
+        if (dx*dx + dy*dy > s.dist2) continue;
+        exact(d, b, g, i, out);
+    }
+}
+
+// Each vector kernel screens as many whole lanes as it can, rechecks the
+// lanes left in its mask with exact(), and returns where the scalar tail
+// resumes.
+#if defined(__AVX2__)
+std::size_t screen_simd(const BasicDetection<double>& d, const Boxes<double>& b,
+                        const Gate<double>& g, const Screen<double>& s, Candidates<double>& out)
+{
+    constexpr std::size_t W = 4;
+    const std::size_t n = b.n - b.n % W;
+    const __m256d half = _mm256_set1_pd(0.5), zero = _mm256_setzero_pd();
+    const __m256d cx = _mm256_set1_pd(s.cx),  cy = _mm256_set1_pd(s.cy);
+    const __m256d lim = _mm256_set1_pd(s.dist2), mi = _mm256_set1_pd(s.min_iou);
+    const __m256d bx = _mm256_set1_pd(d.x), by = _mm256_set1_pd(d.y);
+    const __m256d bx2 = _mm256_set1_pd(d.x + d.w), by2 = _mm256_set1_pd(d.y + d.h);
+    const __m256d barea = _mm256_set1_pd(d.w * d.h);
+    for (std::size_t i=0; i<n; i+=W) {
+        const __m256d x = _mm256_loadu_pd(b.x + i), y = _mm256_loadu_pd(b.y + i);
+        const __m256d w = _mm256_loadu_pd(b.w + i), h = _mm256_loadu_pd(b.h + i);
+        const __m256d dx = _mm256_sub_pd(cx, _mm256_add_pd(x, _mm256_mul_pd(w, half)));
+        const __m256d dy = _mm256_sub_pd(cy, _mm256_add_pd(y, _mm256_mul_pd(h, half)));
+        const __m256d d2 = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        __m256d m = _mm256_cmp_pd(d2, lim, _CMP_LE_OQ);
+        if (!_mm256_movemask_pd(m)) continue;
+
+        const __m256d iw = _mm256_max_pd(_mm256_sub_pd(_mm256_min_pd(bx2, _mm256_add_pd(x, w)),
+                                                       _mm256_max_pd(bx, x)), zero);
+        const __m256d ih = _mm256_max_pd(_mm256_sub_pd(_mm256_min_pd(by2, _mm256_add_pd(y, h)),
+                                                       _mm256_max_pd(by, y)), zero);
+        const __m256d inter = _mm256_mul_pd(iw, ih);
+        const __m256d uni   = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(w, h), barea), inter);
+        const __m256d j     = _mm256_blendv_pd(zero, _mm256_div_pd(inter, uni),
+                                               _mm256_cmp_pd(uni, zero, _CMP_GT_OQ));
+        m = _mm256_and_pd(m, _mm256_cmp_pd(j, mi, _CMP_GE_OQ));
+        for (unsigned bits = unsigned(_mm256_movemask_pd(m)); bits; bits &= bits - 1)
+            exact(d, b, g, i + unsigned(__builtin_ctz(bits)), out);
+    }
+    return n;
+}
+
+std::size_t screen_simd(const BasicDetection<float>& d, const Boxes<float>& b,
+                        const Gate<float>& g, const Screen<float>& s, Candidates<float>& out)
+{
+    constexpr std::size_t W = 8;
+    const std::size_t n = b.n - b.n % W;
+    const __m256 half = _mm256_set1_ps(0.5f), zero = _mm256_setzero_ps();
+    const __m256 cx = _mm256_set1_ps(s.cx),  cy = _mm256_set1_ps(s.cy);
+    const __m256 lim = _mm256_set1_ps(s.dist2), mi = _mm256_set1_ps(s.min_iou);
+    const __m256 bx = _mm256_set1_ps(d.x), by = _mm256_set1_ps(d.y);
+    const __m256 bx2 = _mm256_set1_ps(d.x + d.w), by2 = _mm256_set1_ps(d.y + d.h);
+    const __m256 barea = _mm256_set1_ps(d.w * d.h);
+    for (std::size_t i=0; i<n; i+=W) {
+        const __m256 x = _mm256_loadu_ps(b.x + i), y = _mm256_loadu_ps(b.y + i);
+        const __m256 w = _mm256_loadu_ps(b.w + i), h = _mm256_loadu_ps(b.h + i);
+        const __m256 dx = _mm256_sub_ps(cx, _mm256_add_ps(x, _mm256_mul_ps(w, half)));
+        const __m256 dy = _mm256_sub_ps(cy, _mm256_add_ps(y, _mm256_mul_ps(h, half)));
+        const __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 m = _mm256_cmp_ps(d2, lim, _CMP_LE_OQ);
+        if (!_mm256_movemask_ps(m)) continue;
+
+        const __m256 iw = _mm256_max_ps(_mm256_sub_ps(_mm256_min_ps(bx2, _mm256_add_ps(x, w)),
+                                                      _mm256_max_ps(bx, x)), zero);
+        const __m256 ih = _mm256_max_ps(_mm256_sub_ps(_mm256_min_ps(by2, _mm256_add_ps(y, h)),
+                                                      _mm256_max_ps(by, y)), zero);
+        const __m256 inter = _mm256_mul_ps(iw, ih);
+        const __m256 uni   = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(w, h), barea), inter);
+        const __m256 j     = _mm256_blendv_ps(zero, _mm256_div_ps(inter, uni),
+                                              _mm256_cmp_ps(uni, zero, _CMP_GT_OQ));
+        m = _mm256_and_ps(m, _mm256_cmp_ps(j, mi, _CMP_GE_OQ));
+        for (unsigned bits = unsigned(_mm256_movemask_ps(m)); bits; bits &= bits - 1)
+            exact(d, b, g, i + unsigned(__builtin_ctz(bits)), out);
+    }
+    return n;
+}
+#elif defined(GATE_NEON)
+std::size_t screen_simd(const BasicDetection<double>& d, const Boxes<double>& b,
+                        const Gate<double>& g, const Screen<double>& s, Candidates<double>& out)
+{
+    constexpr std::size_t W = 2;
+    const std::size_t n = b.n - b.n % W;
+    const float64x2_t half = vdupq_n_f64(0.5), zero = vdupq_n_f64(0.0);
+    const float64x2_t cx = vdupq_n_f64(s.cx), cy = vdupq_n_f64(s.cy);
+    const float64x2_t lim = vdupq_n_f64(s.dist2), mi = vdupq_n_f64(s.min_iou);
+    const float64x2_t bx = vdupq_n_f64(d.x), by = vdupq_n_f64(d.y);
+    const float64x2_t bx2 = vdupq_n_f64(d.x + d.w), by2 = vdupq_n_f64(d.y + d.h);
+    const float64x2_t barea = vdupq_n_f64(d.w * d.h);
+    for (std::size_t i=0; i<n; i+=W) {
+        const float64x2_t x = vld1q_f64(b.x + i), y = vld1q_f64(b.y + i);
+        const float64x2_t w = vld1q_f64(b.w + i), h = vld1q_f64(b.h + i);
+        const float64x2_t dx = vsubq_f64(cx, vaddq_f64(x, vmulq_f64(w, half)));
+        const float64x2_t dy = vsubq_f64(cy, vaddq_f64(y, vmulq_f64(h, half)));
+        const float64x2_t d2 = vaddq_f64(vmulq_f64(dx, dx), vmulq_f64(dy, dy));
+        uint64x2_t m = vcleq_f64(d2, lim);
+        if (!(vgetq_lane_u64(m, 0) | vgetq_lane_u64(m, 1))) continue;
+
+        const float64x2_t iw = vmaxq_f64(vsubq_f64(vminq_f64(bx2, vaddq_f64(x, w)), vmaxq_f64(bx, x)), zero);
+        const float64x2_t ih = vmaxq_f64(vsubq_f64(vminq_f64(by2, vaddq_f64(y, h)), vmaxq_f64(by, y)), zero);
+        const float64x2_t inter = vmulq_f64(iw, ih);
+        const float64x2_t uni   = vsubq_f64(vaddq_f64(vmulq_f64(w, h), barea), inter);
+        const float64x2_t j     = vbslq_f64(vcgtq_f64(uni, zero), vdivq_f64(inter, uni), zero);
+        m = vandq_u64(m, vcgeq_f64(j, mi));
+        if (vgetq_lane_u64(m, 0)) exact(d, b, g, i,     out);
+        if (vgetq_lane_u64(m, 1)) exact(d, b, g, i + 1, out);
+    }
+    return n;
+}
+
+std::size_t screen_simd(const BasicDetection<float>& d, const Boxes<float>& b,
+                        const Gate<float>& g, const Screen<float>& s, Candidates<float>& out)
+{
+    constexpr std::size_t W = 4;
+    const std::size_t n = b.n - b.n % W;
+    const float32x4_t half = vdupq_n_f32(0.5f), zero = vdupq_n_f32(0.0f);
+    const float32x4_t cx = vdupq_n_f32(s.cx), cy = vdupq_n_f32(s.cy);
+    const float32x4_t lim = vdupq_n_f32(s.dist2), mi = vdupq_n_f32(s.min_iou);
+    const float32x4_t bx = vdupq_n_f32(d.x), by = vdupq_n_f32(d.y);
+    const float32x4_t bx2 = vdupq_n_f32(d.x + d.w), by2 = vdupq_n_f32(d.y + d.h);
+    const float32x4_t barea = vdupq_n_f32(d.w * d.h);
+    for (std::size_t i=0; i<n; i+=W) {
+        const float32x4_t x = vld1q_f32(b.x + i), y = vld1q_f32(b.y + i);
+        const float32x4_t w = vld1q_f32(b.w + i), h = vld1q_f32(b.h + i);
+        const float32x4_t dx = vsubq_f32(cx, vaddq_f32(x, vmulq_f32(w, half)));
+        const float32x4_t dy = vsubq_f32(cy, vaddq_f32(y, vmulq_f32(h, half)));
+        const float32x4_t d2 = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+        uint32x4_t m = vcleq_f32(d2, lim);
+        if (!vmaxvq_u32(m)) continue;
+
+        const float32x4_t iw = vmaxq_f32(vsubq_f32(vminq_f32(bx2, vaddq_f32(x, w)), vmaxq_f32(bx, x)), zero);
+        const float32x4_t ih = vmaxq_f32(vsubq_f32(vminq_f32(by2, vaddq_f32(y, h)), vmaxq_f32(by, y)), zero);
+        const float32x4_t inter = vmulq_f32(iw, ih);
+        const float32x4_t uni   = vsubq_f32(vaddq_f32(vmulq_f32(w, h), barea), inter);
+        const float32x4_t j     = vbslq_f32(vcgtq_f32(uni, zero), vdivq_f32(inter, uni), zero);
+        m = vandq_u32(m, vcgeq_f32(j, mi));
+        if (!vmaxvq_u32(m)) continue;
+        std::uint32_t lanes[W];
+        vst1q_u32(lanes, m);
+        for (std::size_t k=0; k<W; ++k) if (lanes[k]) exact(d, b, g, i + k, out);
+    }
+    return n;
+}
+#else
+template<class T>
+std::size_t screen_simd(const BasicDetection<T>&, const Boxes<T>&, const Gate<T>&,
+                        const Screen<T>&, Candidates<T>&) { return 0; }
+#endif
+
+} // namespace
+
+template<class T>
+std::size_t candidates(const BasicDetection<T>& d, const Boxes<T>& b, const Gate<T>& g,
+                       Candidates<T>& out)
+{
+    const std::size_t before = out.size();
+    const Screen<T> s(d, g);
+    screen_scalar(d, b, g, s, screen_simd(d, b, g, s, out), out);
+    return out.size() - before;
+}
+
+template std::size_t candidates<float> (const BasicDetection<float>&,  const Boxes<float>&,
+                                        const Gate<float>&,  Candidates<float>&);
+template std::size_t candidates<double>(const BasicDetection<double>&, const Boxes<double>&,
+                                        const Gate<double>&, Candidates<double>&);
+
+} // namespace gate
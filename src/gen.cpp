@@ -0,0 +1,171 @@
+// tracking-gen – native synthetic scene generator (the generate_input.py
+// model, see SceneGen.hpp).  Reads the [generator] section of defaults.ini;
+// every key can be overridden on the command line.
+//
+//   tracking-gen --frames 1000000 --output big.bin --format binary
+//   tracking-gen --output in.json --expected expected.json
+//   tracking-gen --frames 10000 --min_objects 10000 --max_objects 10000 --track
+//
+// --track feeds the frames straight into Tracker::step (no I/O) and reports
+// throughput and ID switches against the generator's ground truth.
+#include "Tracker.hpp"
+#include "FrameIO.hpp"
+#include "BinaryFormat.hpp"
+#include "SceneGen.hpp"
+#include "Config.hpp"
+#include "alloc_count.hpp"
+#include <CLI/CLI.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+/** [generator] key into v, accepting both dt_min and dt-min spellings. */
+template<class T>
+void gen_default(const Config& cfg, std::string key, T& v)
+{
+    if (cfg.read("generator", key, v)) return;
+    for (char& c : key) if (c == '_') c = '-';
+    cfg.read("generator", key, v);
+}
+
+} // namespace
+
+int main(int argc,char** argv)
+{
+    SceneParams p;
+    // name, field; order as in generate_input.py
+    auto each = [&](auto&& f) {
+        f("frames", p.frames);           f("dt_min", p.dt_min);         f("dt_max", p.dt_max);
+        f("min_objects", p.min_objects); f("max_objects", p.max_objects);
+        f("min_life", p.min_life);       f("max_life", p.max_life);
+        f("min_size", p.min_size);       f("max_size", p.max_size);
+        f("bias_x", p.bias_x);           f("bias_y", p.bias_y);
+        f("wind_sigma", p.wind_sigma);   f("wind_max", p.wind_max);
+        f("rot_sigma", p.rot_sigma);     f("scale_sigma", p.scale_sigma);
+        f("step_max", p.step_max);       f("sway_sigma", p.sway_sigma);
+        f("noise_pos", p.noise_pos);     f("noise_size", p.noise_size);
+        f("drop_prob", p.drop_prob);     f("drop_max", p.drop_max);
+        f("seed", p.seed);
+    };
+    std::string out, expected, format = "json", assign = "sparse";
+    bool   track    = false;
+    double max_dist = 0.15, alpha = 0.7, fast_iou = 0.7;
+    int    max_age  = 5;
+    bool   warm     = true;
+    unsigned gate_threads = 1;
+    std::size_t max_tracks = 0;
+    try {
+        const Config cfg = Config::load();
+        each([&](const char* k, auto& v){ gen_default(cfg, k, v); });
+        cfg.read("tracker", "max-dist",   max_dist);
+        cfg.read("tracker", "max-age",    max_age);
+        cfg.read("tracker", "alpha",      alpha);
+        cfg.read("tracker", "warm-start", warm);
+        cfg.read("tracker", "fast-iou",   fast_iou);
+        cfg.read("tracker", "gate-threads", gate_threads);
+        cfg.read("tracker", "max-tracks",   max_tracks);
+    }
+    catch (const std::exception& e) { std::cerr << e.what() << "\n"; return 1; }
+
+    CLI::App app{"tracking-gen"};
+    each([&](const char* k, auto& v){ app.add_option(std::string("--") + k, v, "[generator] " + std::string(k)); });
+    app.add_option("--output",   out,      "detections file");
+    app.add_option("--expected", expected, "ground-truth tracks file (expected.json layout)");
+    app.add_option("--format",   format,   "json | binary | binary-f32")
+        ->check(CLI::IsMember({"json","binary","binary-f32"}));
+    app.add_flag  ("--track",    track,    "run Tracker::step on the frames in-process");
+    app.add_option("--assign",   assign,   "--track: dense | sparse | cascade")
+        ->check(CLI::IsMember({"dense","sparse","cascade"}));
+    app.add_option("--max-dist", max_dist, "--track: centre-distance threshold");
+    app.add_option("--max-age",  max_age,  "--track: frames to keep unmatched track");
+    app.add_option("--alpha",    alpha,    "--track: weight between IoU and distance");
+    app.add_option("--warm-start", warm,   "--track: warm-started dense solves (true | false)");
+    app.add_option("--fast-iou", fast_iou, "--track: cascade fast-path IoU");
+    app.add_option("--gate-threads", gate_threads, "--track: gating threads (0 = one per core)");
+    app.add_option("--max-tracks", max_tracks, "--track: live track limit (0 = unbounded)");
+    CLI11_PARSE(app,argc,argv);
+
+    if (out.empty() && expected.empty() && !track) {
+        std::cerr << "nothing to do: give --output, --expected and/or --track\n";
+        return 1;
+    }
+
+    try {
+        const bool binary = format != "json", f32 = format == "binary-f32";
+        std::ofstream fdet, fexp;
+        std::unique_ptr<JsonFrameWriter>   jdet;
+        std::unique_ptr<BinaryFrameWriter> bdet;
+        std::unique_ptr<LabelSink>         truth_sink;
+        if (!out.empty()) {
+            fdet.open(out, std::ios::binary);
+            if (!fdet) throw std::runtime_error("cannot create " + out);
+            if (binary) bdet = std::make_unique<BinaryFrameWriter>(fdet, f32);
+            else        jdet = std::make_unique<JsonFrameWriter>(fdet);
+        }
+        if (!expected.empty()) {
+            fexp.open(expected, std::ios::binary);
+            if (!fexp) throw std::runtime_error("cannot create " + expected);
+            if (binary) truth_sink = std::make_unique<BinaryLabelWriter>(fexp, f32);
+            else        truth_sink = std::make_unique<JsonFrameWriter>(fexp);
+        }
+
+        Tracker tracker(max_dist, max_age, alpha, assigner_from(assign), warm, fast_iou);
+        tracker.set_parallel_gate(gate_threads);
+        tracker.set_track_limit(max_tracks);
+        struct Seen { int track_id; std::size_t frame; };
+        std::unordered_map<int,Seen> last_id;         // truth id -> track id
+        std::size_t n_dets = 0, switches = 0, n = 0;
+        std::chrono::steady_clock::duration busy{};
+        std::uint64_t warm_allocs = 0;                // inside step, after frame 100
+
+        SceneGenerator gen(p);
+        Frame fr;
+        std::vector<Label> truth;
+        while (gen.next(fr)) {
+            ++n; n_dets += fr.dets.size();
+            if (bdet) bdet->write(fr.ts, fr.dets.data(), fr.dets.size());
+            if (jdet) jdet->write_dets(fr.ts, fr.dets.data(), fr.dets.size());
+            if (truth_sink) {
+                truth.clear();
+                for (std::size_t i=0; i<fr.dets.size(); ++i) truth.push_back({gen.truth()[i], fr.dets[i]});
+                truth_sink->write(fr.ts, truth);
+            }
+            if (track) {
+                const std::uint64_t a0 = alloc::thread_count();
+                const auto t0 = std::chrono::steady_clock::now();
+                const auto& labels = tracker.step(fr.ts, fr.dets.data(), fr.dets.size());
+                busy += std::chrono::steady_clock::now() - t0;
+                if (n > 100) warm_allocs += alloc::thread_count() - a0;
+                // every detection gets a label, in detection order
+                for (std::size_t i=0; i<labels.size(); ++i) {
+                    auto [it, fresh] = last_id.try_emplace(gen.truth()[i], Seen{labels[i].track_id, n});
+                    if (!fresh && it->second.track_id != labels[i].track_id) ++switches;
+                    it->second = {labels[i].track_id, n};
+                }
+                // objects live at most max_life frames: forget the dead ones
+                if (n % 1024 == 0)
+                    for (auto it = last_id.begin(); it != last_id.end(); )
+                        it = it->second.frame + std::size_t(p.max_life) < n ? last_id.erase(it) : std::next(it);
+            }
+        }
+        if (jdet) jdet->finish();
+        if (truth_sink) truth_sink->finish();
+
+        std::cout << "Generated " << n << " frames, " << n_dets << " detections.\n";
+        if (track) {
+            const double s = std::chrono::duration<double>(busy).count();
+            std::cout << "Tracker::step: " << s << " s, " << (s > 0 ? n / s : 0.0) << " frames/s, "
+                      << (s > 0 ? n_dets / s : 0.0) << " detections/s, "
+                      << switches << " id switches\n";
+            if (alloc::enabled)
+                std::cout << "Heap allocations in step after frame 100: " << warm_allocs << "\n";
+        }
+    }
+    catch (const std::exception& e) { std::cerr << e.what() << "\n"; return 1; }
+    return 0;
+}
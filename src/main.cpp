@@ -1,130 +1,246 @@
 #include "Tracker.hpp"
-#include <nlohmann/json.hpp>
+#include "FrameIO.hpp"
+#include "BinaryFormat.hpp"
+#include "QuantLabels.hpp"
+#include "VisPipeline.hpp"
+#include "Pipeline.hpp"
+#include "MultiStream.hpp"
+#include "LiveServer.hpp"
+#include "Checkpoint.hpp"
+#include "Config.hpp"
 #include <CLI/CLI.hpp>
-#include <opencv2/opencv.hpp>
 #include <fstream>
 #include <iostream>
-#include <iomanip>
-#include <sstream>
 #include <filesystem>
-#include <regex>
-
-// ───────────────── timestamps ───────────────────────────────────────
-static double parse_iso(const std::string& s)
-{
-    std::tm tm{}; char dot; double frac = 0.0;
-    std::istringstream ss(s);
-    ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
-    if (ss.peek() == '.') { ss >> dot; std::string us; ss >> us; frac = std::stod("0."+us); }
-    return static_cast<double>(timegm(&tm)) + frac;
-}
-
-static std::string format_iso(double sec)
-{
-    std::time_t ti = static_cast<std::time_t>(sec);
-    double frac = sec - ti;
-    std::tm *tm = gmtime(&ti);
-    char buf[32]; strftime(buf,sizeof(buf),"%Y-%m-%dT%H:%M:%S",tm);
-    std::ostringstream out; out << buf << '.' << std::setw(6) << std::setfill('0')
-                                << int(frac*1e6 + 0.5);
-    return out.str();
-}
-
-// ───────────────── INI helper ───────────────────────────────────────
-static std::string ini(const std::string& sec, const std::string& key,
-                       const std::string& path="defaults.ini")
-{
-    std::ifstream f(path); if(!f) return "";
-    std::regex      re_sec(R"(\[(.+?)\])");
-    std::regex      re_kv (R"(^\s*([^=]+?)\s*=\s*(.*?)\s*(?:[#;].*)?$)");
-    std::string line, cur; std::smatch m;
-    while (std::getline(f,line)) {
-        if (std::regex_match(line,m,re_sec))        cur = m[1];
-        else if (cur==sec && std::regex_match(line,m,re_kv) && m[1]==key) return m[2];
-    }
-    return "";
-}
-
-// ───────────────── I/O helpers ──────────────────────────────────────
-struct Frame { double ts; std::vector<Detection> dets; };
-
-static std::vector<Frame> load_frames(const std::string& path)
-{
-    std::ifstream in(path); nlohmann::json j; in >> j;
-    std::vector<Frame> v;
-    for (auto& f : j) {
-        Frame fr; fr.ts = parse_iso(f["timestamp"]);
-        for (auto& d : f["detections"])
-            fr.dets.push_back({d["x"], d["y"], d["w"], d["h"]});
-        v.push_back(std::move(fr));
-    }
-    return v;
-}
-
-static void draw_vis(const std::string& dir,int idx,
-                     const std::vector<Track>& trks,int W=800,int H=600)
-{
-    cv::Mat img(H,W,CV_8UC3, cv::Scalar(35,35,35));
-    for (auto& t:trks) {
-        int x=int(t.rect.at<double>(0)*W), y=int(t.rect.at<double>(1)*H);
-        int w=int(t.rect.at<double>(2)*W), h=int(t.rect.at<double>(3)*H);
-        cv::rectangle(img,{x,y,w,h}, {0,255,0},2);
-        cv::putText(img,std::to_string(t.id),{x,y-5},
-                    cv::FONT_HERSHEY_SIMPLEX,0.5,{0,255,255},1);
-    }
-    std::ostringstream fn; fn<<dir<<"/frame_"<<std::setw(4)<<std::setfill('0')<<idx<<".png";
-    cv::imwrite(fn.str(), img);
-}
 
 // ────────────────────────────────────────────────────────────────────
 int main(int argc,char** argv)
 {
-    // defaults from INI
-    std::string in   = ini("tracker","input");
-    std::string out  = ini("tracker","output");
-    std::string vis  = ini("tracker","vis-dir");
-    double max_dist  = ini("tracker","max-dist").empty()?0.15:std::stod(ini("tracker","max-dist"));
-    int    max_age   = ini("tracker","max-age").empty()?5:std::stoi(ini("tracker","max-age"));
-    double alpha     = ini("tracker","alpha").empty()?0.7:std::stod(ini("tracker","alpha"));
+    // defaults from INI, parsed once
+    const Config cfg = Config::load();
+    std::string in, out, assign = "dense", ingest = "mmap", out_fmt = "json";
+    std::string pipeline = "sequential", live, metrics_path, metrics_fmt = "json";
+    double      max_dist = 0.15, alpha = 0.7, fast_iou = 0.7;
+    int         max_age  = 5;
+    bool        warm     = true;
+    unsigned    gate_threads = 1;
+    std::size_t gate_min_pairs = Tracker::parallel_gate_pairs;
+    std::size_t max_tracks = 0;
+    std::string compress = "none";
+    std::uint32_t block_frames = QuantLabelWriter::default_block_frames;
+    std::size_t metrics_every = 0;
+    std::string checkpoint, resume;
+    std::size_t checkpoint_every = 0;
+    VisOptions         vopt;
+    PipelineOptions    popt;
+    MultiStreamOptions mopt;
+    LiveOptions        lopt;
+    ChunkOptions       copt;
+    try {
+        cfg.read("tracker", "input",         in);
+        cfg.read("tracker", "output",        out);
+        cfg.read("tracker", "max-dist",      max_dist);
+        cfg.read("tracker", "max-age",       max_age);
+        cfg.read("tracker", "alpha",         alpha);
+        cfg.read("tracker", "assign",        assign);
+        cfg.read("tracker", "warm-start",    warm);
+        cfg.read("tracker", "fast-iou",      fast_iou);
+        cfg.read("tracker", "gate-threads",  gate_threads);
+        cfg.read("tracker", "gate-min-pairs", gate_min_pairs);
+        cfg.read("tracker", "max-tracks",    max_tracks);
+        cfg.read("tracker", "ingest",        ingest);
+        cfg.read("tracker", "output-format", out_fmt);
+        cfg.read("tracker", "compress",      compress);
+        cfg.read("tracker", "block-frames",  block_frames);
+        cfg.read("pipeline", "mode",         pipeline);
+        cfg.read("live",    "listen",        live);
+        cfg.read("metrics", "path",          metrics_path);
+        cfg.read("metrics", "format",        metrics_fmt);
+        cfg.read("metrics", "every",         metrics_every);
+        cfg.read("checkpoint", "path",       checkpoint);
+        cfg.read("checkpoint", "every",      checkpoint_every);
+        cfg.read("checkpoint", "resume",     resume);
+        vopt = VisOptions::from(cfg);
+        popt = PipelineOptions::from(cfg);
+        mopt = MultiStreamOptions::from(cfg);
+        lopt = LiveOptions::from(cfg);
+        copt = ChunkOptions::from(cfg);
+    }
+    catch (const std::exception& e) { std::cerr << e.what() << "\n"; return 1; }
+    std::string vis = vopt.dir;
 
     CLI::App app{"tracking-solution"};
-    app.add_option("--input",   in,  "input JSON");
-    app.add_option("--output",  out, "output JSON");
+    app.add_option("--input",   in,  "input JSON or binary frame stream");
+    app.add_option("--output",  out, "output file");
     app.add_option("--vis-dir", vis, "visualisation directory");
+    app.add_option("--vis",     vopt.mode, "visualisation: off | png (per frame) | video (tracks.mp4)")
+        ->check(CLI::IsMember({"off","png","video"}));
+    app.add_option("--vis-every",   vopt.every,   "render every Nth frame");
+    app.add_option("--vis-threads", vopt.threads, "encoder threads");
+    app.add_option("--vis-queue",   vopt.queue,   "max frames waiting for an encoder");
     app.add_option("--max-dist",max_dist,"centre-distance threshold");
     app.add_option("--max-age", max_age,"frames to keep unmatched track");
     app.add_option("--alpha",   alpha,  "weight between IoU and distance");
+    app.add_option("--assign",  assign, "association solver: dense | sparse | cascade (greedy fast path, then dense)")
+        ->check(CLI::IsMember({"dense","sparse","cascade"}));
+    app.add_option("--warm-start", warm, "dense: seed each solve from the previous frame's duals (true | false)");
+    app.add_option("--fast-iou", fast_iou, "cascade: IoU above which mutually best pairs skip the solver (>1: unique pairs only)");
+    app.add_option("--gate-threads", gate_threads, "gating threads per tracker (0 = one per core, 1 = serial)");
+    app.add_option("--gate-min-pairs", gate_min_pairs, "track x detection pairs from which a frame is gated in parallel");
+    app.add_option("--max-tracks", max_tracks, "live tracks per tracker; the stalest unmatched are evicted beyond (0: unbounded)");
+    app.add_option("--ingest",  ingest, "input reader: mmap (fast parser) | stream (istream, pipes)")
+        ->check(CLI::IsMember({"mmap","stream"}));
+    app.add_option("--output-format", out_fmt,
+                   "json | jsonl (one object per line) | json-min (no whitespace) | binary | binary-f32"
+                   " | binary-q16 (16-bit coordinates, per-track deltas)")
+        ->check(CLI::IsMember({"json","jsonl","json-min","binary","binary-f32","binary-q16"}));
+    app.add_option("--compress", compress, "binary-q16: block compression, none | zstd | lz4")
+        ->check(CLI::IsMember({"none","zstd","lz4"}));
+    app.add_option("--block-frames", block_frames, "binary-q16: frames per block (deltas restart every block)");
+    app.add_option("--pipeline", pipeline,
+                   "sequential | threaded (parse, track, serialise on 3 threads) | multi (one tracker per stream id)"
+                   " | chunked (time chunks in parallel, ids stitched)")
+        ->check(CLI::IsMember({"sequential","threaded","multi","chunked"}));
+    app.add_option("--frame-queue", popt.frame_queue, "threaded: parsed frames buffered ahead of the tracker");
+    app.add_option("--label-queue", popt.label_queue, "threaded: label frames buffered ahead of the writer");
+    app.add_option("--workers", mopt.workers, "multi: worker threads (0 = one per core)");
+    app.add_option("--window",  mopt.window,  "multi: frames in flight between reader and writer");
+    app.add_option("--batch-streams", mopt.batch_streams,
+                   "multi: step up to N streams at once per worker on --backend (0 = off)");
+    app.add_option("--backend", mopt.backend, "multi: batch backend for --batch-streams (cpu | opencl)")
+        ->check(CLI::IsMember({"cpu","opencl"}));
+    app.add_option("--chunks",  copt.chunks,  "chunked: number of chunks (0 = one per worker)");
+    app.add_option("--overlap", copt.overlap, "chunked: warm-up frames shared with the previous chunk");
+    app.add_option("--checkpoint", checkpoint, "save the tracker state here at the end of the run (empty: off)");
+    app.add_option("--checkpoint-every", checkpoint_every, "also save it every N frames (0: at the end only)");
+    app.add_option("--resume", resume, "start from this checkpoint; skips input frames it already covers");
+    app.add_option("--live", live, "track frames as they arrive: stdio | unix:PATH | tcp:[HOST:]PORT (empty: off)");
+    app.add_option("--latency-budget-ms", lopt.budget_ms, "live: per-frame budget, receive to reply (0: none)");
+    app.add_option("--partial-queue", lopt.overload.partial_queue,
+                   "live: frames waiting from which to keep only the unambiguous matches (0: off)");
+    app.add_option("--coast-queue", lopt.overload.coast_queue,
+                   "live: frames waiting from which to only predict (coast) (0: off)");
+    app.add_option("--partial-ms", lopt.overload.partial_ms, "live: same, by recent step latency (0: off)");
+    app.add_option("--coast-ms",   lopt.overload.coast_ms,   "live: same, by recent step latency (0: off)");
+    app.add_option("--max-degraded", lopt.overload.max_degraded,
+                   "live: degraded frames in a row before one full frame");
+    app.add_option("--live-format", lopt.format, "live: reply format, jsonl | json | binary | binary-f32")
+        ->check(CLI::IsMember({"jsonl","json","binary","binary-f32"}));
+    app.add_option("--metrics", metrics_path, "write stage latencies / counters here (empty: off)");
+    app.add_option("--metrics-format", metrics_fmt, "json | prometheus")
+        ->check(CLI::IsMember({"json","prometheus"}));
+    app.add_option("--metrics-every", metrics_every, "also rewrite the metrics file every N frames (0: at exit)");
     CLI11_PARSE(app,argc,argv);
 
-    std::filesystem::create_directories(vis);
+    // live: no input / output files, labels go back as each frame arrives
+    if (!live.empty()) {
+        lopt.listen = live;
+        if (!metrics_path.empty()) {
+            lopt.report_every = metrics_every;
+            lopt.report = [&](const metrics::Registry& r) { metrics::write_file(metrics_path, metrics_fmt, r); };
+        }
+        try {
+            Tracker prototype(max_dist,max_age,alpha,assigner_from(assign),warm,fast_iou);
+            prototype.set_parallel_gate(gate_threads, gate_min_pairs);
+            prototype.set_track_limit(max_tracks);
+            LiveServer server(prototype, lopt);
+            const std::size_t n = server.run();
+            std::cerr << "Tracking complete – " << n << " frames processed.\n";
+        }
+        catch (const std::exception& e) { std::cerr << e.what() << "\n"; return 1; }
+        return 0;
+    }
 
-    // load & run
-    auto frames = load_frames(in);
-    Tracker tracker(max_dist,max_age,alpha);
-    nlohmann::ordered_json dump = nlohmann::json::array();
+    vopt.dir = vis;
+    copt.workers = mopt.workers;
+    const bool per_chunk = pipeline == "multi" || pipeline == "chunked";
+    if (per_chunk && vopt.mode != "off") {
+        std::cerr << "note: visualisation is per tracker; disabled with --pipeline " << pipeline << "\n";
+        vopt.mode = "off";
+    }
+    if (per_chunk && (!checkpoint.empty() || !resume.empty())) {
+        std::cerr << "--checkpoint / --resume need a single tracker (sequential or threaded)\n";
+        return 1;
+    }
+    if (vopt.mode != "off") std::filesystem::create_directories(vis);
 
-    for (size_t i=0;i<frames.size();++i)
-    {
-        auto labels = tracker.step(frames[i].ts, frames[i].dets);
+    // stream frames through the tracker; memory is constant in #frames
+    std::unique_ptr<FrameSource> reader;
+    try { reader = open_frames(in, ingest); }
+    catch (const std::exception& e) { std::cerr << e.what() << "\n"; return 1; }
+    std::ofstream fout(out, std::ios::binary);
+    std::unique_ptr<LabelSink> writer;
+    const bool streams = pipeline == "multi";          // tag each output frame with its stream
+    try {
+        if (out_fmt == "json")     writer = std::make_unique<JsonFrameWriter>(fout, streams);
+        else if (out_fmt == "jsonl")
+            writer = std::make_unique<JsonFrameWriter>(fout, streams, JsonFrameWriter::Layout::Lines);
+        else if (out_fmt == "json-min")
+            writer = std::make_unique<JsonFrameWriter>(fout, streams, JsonFrameWriter::Layout::Minified);
+        else if (out_fmt == "binary-q16")
+            writer = std::make_unique<QuantLabelWriter>(fout, streams, bin::codec_from(compress), block_frames);
+        else
+            writer = std::make_unique<BinaryLabelWriter>(fout, out_fmt == "binary-f32", streams);
+    }
+    catch (const std::exception& e) { std::cerr << e.what() << "\n"; return 1; }
+    Tracker tracker(max_dist,max_age,alpha,assigner_from(assign),warm,fast_iou);
+    tracker.set_parallel_gate(gate_threads, gate_min_pairs);
+    tracker.set_track_limit(max_tracks);
+    if (!resume.empty()) {
+        // the snapshot's parameters and track ids carry on from the saved run
+        try { load_checkpoint(resume, tracker); }
+        catch (const std::exception& e) { std::cerr << e.what() << "\n"; return 1; }
+        reader = std::make_unique<ResumeSource>(std::move(reader), tracker.time());
+    }
+    std::unique_ptr<VisPipeline> vis_pipe;
+    try { vis_pipe = std::make_unique<VisPipeline>(vopt); }
+    catch (const std::exception& e) { std::cerr << e.what() << "\n"; return 1; }
 
-        // build output object with RAW rectangle
-        nlohmann::ordered_json obj;
-        obj["timestamp"] = format_iso(frames[i].ts);
-        for (auto& L : labels) {
-            obj["tracks"].push_back({
-                {"id", L.track_id},
-                {"x",  L.det.x},
-                {"y",  L.det.y},
-                {"w",  L.det.w},
-                {"h",  L.det.h}
-            });
-        }
-        dump.push_back(std::move(obj));
+    if (!metrics_path.empty() && !metrics::enabled)
+        std::cerr << "note: built without TRACKER_METRICS; " << metrics_path << " will only hold zeros\n";
+    metrics::Registry io_metrics;
+    auto report = [&](const metrics::Registry& r) {
+        if (!metrics_path.empty()) metrics::write_file(metrics_path, metrics_fmt, r);
+    };
+    RunHooks hooks;
+    hooks.vis = vis_pipe.get();
+    hooks.io  = &io_metrics;
+    const bool periodic_metrics = !metrics_path.empty() && metrics_every;
+    const bool periodic_checkpoint = !checkpoint.empty() && checkpoint_every;
+    if (periodic_metrics || periodic_checkpoint)
+        hooks.on_frame = [&](size_t frames) {
+            if (periodic_checkpoint && frames % checkpoint_every == 0) save_checkpoint(checkpoint, tracker);
+            if (!periodic_metrics || frames % metrics_every) return;
+            metrics::Registry r = tracker.metrics();
+            r.merge(io_metrics);
+            report(r);
+        };
 
-        draw_vis(vis, static_cast<int>(i), tracker.tracks());
+    size_t n = 0;
+    try {
+        if (pipeline == "multi") {
+            MultiStreamEngine engine(tracker, mopt);
+            n = engine.run(*reader, *writer);
+            report(engine.metrics());
+        }
+        else if (pipeline == "chunked") {
+            metrics::Registry r;
+            n = run_chunked(*reader, tracker, *writer, copt, &r);
+            report(r);
+        }
+        else {
+            n = pipeline == "threaded" ? run_pipelined (*reader, tracker, *writer, hooks, popt)
+                                       : run_sequential(*reader, tracker, *writer, hooks);
+            metrics::Registry r = tracker.metrics();
+            r.merge(io_metrics);
+            report(r);
+            if (!checkpoint.empty()) save_checkpoint(checkpoint, tracker);
+        }
     }
+    catch (const std::exception& e) { std::cerr << e.what() << "\n"; return 1; }
+    writer->finish();
+    vis_pipe->finish();
 
-    std::ofstream(out) << std::setw(2) << dump;
-    std::cout << "Tracking complete – " << frames.size() << " frames processed.\n";
+    std::cout << "Tracking complete – " << n << " frames processed.\n";
     return 0;
 }
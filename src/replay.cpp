@@ -0,0 +1,321 @@
+// tracker-replay – run one input through several Tracker variants in one
+// process; report throughput, per-frame latency and ID differences.
+//
+//   tracker-replay --input tests/input.json --expected tests/expected.json
+//   tracker-replay --input big.bin --variant assign=dense --variant assign=sparse,precision=float
+//
+// Each variant re-reads the input (mapped for binary and the mmap JSON
+// ingest) and only Tracker::step is timed.  Its labels are checked frame
+// by frame against the reference: --expected (JSON or binary labels, e.g.
+// tracking-gen --expected), or else the first variant.  A reference id
+// that is followed by a different track id than before is an ID switch,
+// as in tracking-gen --track.  With --max-switches N the exit status is 1
+// when any variant has more than N switches (for CI gates).
+#include "Tracker.hpp"
+#include "FrameIO.hpp"
+#include "BinaryFormat.hpp"
+#include "QuantLabels.hpp"
+#include "Metrics.hpp"
+#include "Config.hpp"
+#include <nlohmann/json.hpp>
+#include <CLI/CLI.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <variant>
+
+namespace {
+
+struct Params
+{
+    double   max_dist = 0.15, alpha = 0.7, fast_iou = 0.7;
+    int      max_age  = 5;
+    Assigner assigner = Assigner::Dense;
+    bool     warm     = true, single = false;
+    unsigned gate_threads = 1;
+    std::size_t max_tracks = 0;
+};
+
+using AnyTracker = std::variant<TrackerD, TrackerF>;
+
+/** "key=value,key=value" on top of base; throws on unknown keys. */
+Params parse_variant(const std::string& spec, Params p)
+{
+    std::istringstream in(spec);
+    std::string kv;
+    while (std::getline(in, kv, ',')) {
+        if (kv.empty()) continue;
+        const auto eq = kv.find('=');
+        if (eq == std::string::npos) throw std::invalid_argument("variant '" + spec + "': expected key=value");
+        const std::string k = kv.substr(0, eq), v = kv.substr(eq + 1);
+        if      (k == "assign")     p.assigner = assigner_from(v);
+        else if (k == "precision") {
+            if (v != "double" && v != "float") throw std::invalid_argument("precision must be double or float");
+            p.single = v == "float";
+        }
+        else if (k == "warm-start") p.warm     = v != "false";
+        else if (k == "fast-iou")   p.fast_iou = std::stod(v);
+        else if (k == "max-dist")   p.max_dist = std::stod(v);
+        else if (k == "max-age")    p.max_age  = std::stoi(v);
+        else if (k == "alpha")      p.alpha    = std::stod(v);
+        else if (k == "gate-threads") p.gate_threads = unsigned(std::stoul(v));
+        else if (k == "max-tracks") p.max_tracks = std::stoul(v);
+        else throw std::invalid_argument("variant '" + spec + "': unknown key '" + k + "'");
+    }
+    return p;
+}
+
+AnyTracker make_tracker(const Params& p)
+{
+    AnyTracker t = p.single ? AnyTracker(TrackerF(p.max_dist, p.max_age, p.alpha, p.assigner, p.warm, p.fast_iou))
+                            : AnyTracker(TrackerD(p.max_dist, p.max_age, p.alpha, p.assigner, p.warm, p.fast_iou));
+    std::visit([&](auto& tr){ tr.set_parallel_gate(p.gate_threads); tr.set_track_limit(p.max_tracks); }, t);
+    return t;
+}
+
+/** Reference labels frame by frame: a TRKL / TRKQ file or a JSON `tracks` stream. */
+class LabelSource
+{
+public:
+    explicit LabelSource(const std::string& path)
+    {
+        const bin::Kind kind = bin::sniff_file(path);
+        if (kind == bin::Kind::Labels)      { bin_   = std::make_unique<BinaryLabelReader>(path); return; }
+        if (kind == bin::Kind::QuantLabels) { quant_ = std::make_unique<QuantLabelReader>(path);  return; }
+        file_.open(path, std::ios::binary);
+        if (!file_) throw std::runtime_error("cannot open " + path);
+        objs_ = std::make_unique<JsonObjectStream>(file_);
+    }
+
+    bool next(std::vector<Label>& labels)
+    {
+        double ts;
+        if (bin_)   return bin_->next(ts, labels);
+        if (quant_) return quant_->next(ts, labels);
+        if (!objs_->next(buf_)) return false;
+        const auto f = nlohmann::json::parse(buf_);
+        labels.clear();
+        if (f.contains("tracks"))
+            for (auto& t : f["tracks"])
+                labels.push_back({t["id"].get<int>(), {t["x"], t["y"], t["w"], t["h"]}});
+        return true;
+    }
+
+private:
+    std::unique_ptr<BinaryLabelReader> bin_;
+    std::unique_ptr<QuantLabelReader>  quant_;
+    std::ifstream                      file_;
+    std::unique_ptr<JsonObjectStream>  objs_;
+    std::string                        buf_;
+};
+
+/**
+ * Follows which track id carries each reference id.  A reference label is
+ * paired with the output label of the same detection (same index and box,
+ * to within `quantum` for a quantised TRKQ reference), else with the first
+ * output label within `threshold` of its box, as compare_tracks.py does.
+ */
+class IdDiff
+{
+public:
+    static constexpr double threshold = 0.01;
+    static constexpr double quantum   = 1e-5;    // > TRKQ rounding error (7.7e-6)
+
+    void frame(std::size_t n, const std::vector<Label>& ref, const std::vector<Label>& out)
+    {
+        std::size_t sw = 0;
+        for (std::size_t i=0; i<ref.size(); ++i) {
+            const Label* o = match(ref[i], i, out);
+            if (!o) { ++unmatched; continue; }
+            auto [it, fresh] = last_.try_emplace(ref[i].track_id, Seen{o->track_id, n});
+            if (!fresh && it->second.track_id != o->track_id) ++sw;
+            it->second = {o->track_id, n};
+        }
+        if (sw || ref.size() != out.size()) {
+            if (!frames_differ++) first_diff = n;
+        }
+        switches += sw;
+        // reference ids unseen for a long time are forgotten, so memory stays
+        // bounded by the objects alive in a window rather than all ever seen
+        if (n % 4096 == 0)
+            for (auto it = last_.begin(); it != last_.end(); )
+                it = it->second.frame + 4096 < n ? last_.erase(it) : std::next(it);
+    }
+
+    std::size_t switches = 0, unmatched = 0, frames_differ = 0, first_diff = 0;
+
+private:
+    struct Seen { int track_id; std::size_t frame; };
+
+    static bool same(const Detection& a, const Detection& b)
+    {
+        return std::abs(a.x - b.x) <= quantum && std::abs(a.y - b.y) <= quantum &&
+               std::abs(a.w - b.w) <= quantum && std::abs(a.h - b.h) <= quantum;
+    }
+
+    static const Label* match(const Label& r, std::size_t i, const std::vector<Label>& out)
+    {
+        if (i < out.size() && same(r.det, out[i].det)) return &out[i];
+        for (const Label& o : out) {
+            const double dx = r.det.x - o.det.x, dy = r.det.y - o.det.y,
+                         dw = r.det.w - o.det.w, dh = r.det.h - o.det.h;
+            if (std::sqrt(dx*dx + dy*dy + dw*dw + dh*dh) < threshold) return &o;
+        }
+        return nullptr;
+    }
+
+    std::unordered_map<int,Seen> last_;
+};
+
+struct Result
+{
+    std::string       name;
+    std::size_t       frames = 0, dets = 0;
+    double            seconds = 0;
+    metrics::Histogram latency;
+    IdDiff            diff;
+    bool              compared = false;
+};
+
+/**
+ * One pass of `v` over the input.  `ref` (the first variant, when there is
+ * no --expected) steps alongside untimed so its labels can be compared.
+ */
+Result run(const std::string& name, AnyTracker v, const std::string& input,
+           const std::string& ingest, const std::string& expected, AnyTracker* ref)
+{
+    Result r; r.name = name;
+    auto src = open_frames(input, ingest);
+    std::unique_ptr<LabelSource> exp;
+    if (!expected.empty()) exp = std::make_unique<LabelSource>(expected);
+    r.compared = exp || ref;
+
+    FrameView fr;
+    std::vector<Label> ref_labels;
+    std::chrono::steady_clock::duration busy{};
+    while (src->next_view(fr)) {
+        const auto t0 = std::chrono::steady_clock::now();
+        const std::vector<Label>& labels =
+            std::visit([&](auto& t) -> const std::vector<Label>& { return t.step(fr.ts, fr.dets, fr.n); }, v);
+        const auto dt = std::chrono::steady_clock::now() - t0;
+        busy += dt;
+        r.latency.record(std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count()));
+
+        if (exp) {
+            if (!exp->next(ref_labels))
+                throw std::runtime_error(expected + " ends before frame " + std::to_string(r.frames));
+            r.diff.frame(r.frames, ref_labels, labels);
+        }
+        else if (ref) {
+            const auto& rl = std::visit([&](auto& t) -> const std::vector<Label>& { return t.step(fr.ts, fr.dets, fr.n); }, *ref);
+            r.diff.frame(r.frames, rl, labels);
+        }
+        ++r.frames; r.dets += fr.n;
+    }
+    if (exp && exp->next(ref_labels))
+        throw std::runtime_error(expected + " has more frames than " + input);
+    r.seconds = std::chrono::duration<double>(busy).count();
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Params base;
+    std::string input, expected, ingest = "mmap", report;
+    try {
+        const Config cfg = Config::load();
+        cfg.read("tracker", "max-dist",   base.max_dist);
+        cfg.read("tracker", "max-age",    base.max_age);
+        cfg.read("tracker", "alpha",      base.alpha);
+        cfg.read("tracker", "fast-iou",   base.fast_iou);
+        cfg.read("tracker", "warm-start", base.warm);
+        cfg.read("tracker", "gate-threads", base.gate_threads);
+        cfg.read("tracker", "max-tracks",   base.max_tracks);
+        cfg.read("tracker", "input",      input);
+    }
+    catch (const std::exception& e) { std::cerr << e.what() << "\n"; return 1; }
+    std::vector<std::string> specs;
+    long max_switches = -1;
+
+    CLI::App app{"tracker-replay"};
+    app.add_option("--input",    input,    "frames (JSON or binary)");
+    app.add_option("--expected", expected, "reference labels (JSON or binary); default: the first variant");
+    app.add_option("--variant",  specs,
+                   "key=value,... over assign, precision (double | float), warm-start, fast-iou, "
+                   "max-dist, max-age, alpha, gate-threads, max-tracks; repeatable (default: every assigner in both precisions)");
+    app.add_option("--max-dist", base.max_dist, "base centre-distance threshold");
+    app.add_option("--max-age",  base.max_age,  "base frames to keep unmatched track");
+    app.add_option("--alpha",    base.alpha,    "base weight between IoU and distance");
+    app.add_option("--ingest",   ingest,        "JSON reader: mmap | stream")
+        ->check(CLI::IsMember({"mmap","stream"}));
+    app.add_option("--json",     report,        "also write the results here as JSON");
+    app.add_option("--max-switches", max_switches, "exit 1 if a variant has more ID switches (-1: never)");
+    CLI11_PARSE(app, argc, argv);
+
+    if (specs.empty())
+        for (const char* a : {"dense", "sparse", "cascade"})
+            for (const char* p : {"double", "float"})
+                specs.push_back(std::string("assign=") + a + ",precision=" + p);
+
+    std::vector<Result> results;
+    try {
+        std::vector<Params> params;
+        for (const auto& s : specs) params.push_back(parse_variant(s, base));
+        for (std::size_t i=0; i<specs.size(); ++i) {
+            AnyTracker ref = make_tracker(params[0]);
+            const bool vs_first = expected.empty() && i > 0;
+            results.push_back(run(specs[i], make_tracker(params[i]), input, ingest, expected,
+                                  vs_first ? &ref : nullptr));
+        }
+    }
+    catch (const std::exception& e) { std::cerr << e.what() << "\n"; return 1; }
+
+    const std::string against = expected.empty() ? "vs " + specs[0] : "vs " + expected;
+    std::printf("%-36s %8s %11s %9s %9s %9s %9s %8s  (%s)\n", "variant", "frames", "frames/s",
+                "p50_us", "p99_us", "max_us", "switches", "differ", against.c_str());
+    bool clean = true;
+    nlohmann::ordered_json j = nlohmann::ordered_json::array();
+    for (const Result& r : results) {
+        const double fps = r.seconds > 0 ? r.frames / r.seconds : 0.0;
+        const double p50 = r.latency.quantile(0.50) * 1e-3, p99 = r.latency.quantile(0.99) * 1e-3,
+                     mx  = r.latency.max() * 1e-3;
+        if (r.compared)
+            std::printf("%-36s %8zu %11.0f %9.1f %9.1f %9.1f %9zu %8zu\n", r.name.c_str(), r.frames, fps,
+                        p50, p99, mx, r.diff.switches, r.diff.frames_differ);
+        else
+            std::printf("%-36s %8zu %11.0f %9.1f %9.1f %9.1f %9s %8s\n", r.name.c_str(), r.frames, fps,
+                        p50, p99, mx, "-", "-");
+        if (r.diff.frames_differ) {
+            std::printf("%-36s first difference at frame %zu", "", r.diff.first_diff);
+            if (r.diff.unmatched) std::printf(", %zu reference labels unmatched", r.diff.unmatched);
+            std::printf("\n");
+        }
+        if (max_switches >= 0 && r.diff.switches > std::size_t(max_switches)) clean = false;
+
+        nlohmann::ordered_json v = {
+            {"variant", r.name}, {"frames", r.frames}, {"detections", r.dets},
+            {"step_seconds", r.seconds}, {"frames_per_second", fps},
+            {"p50_us", p50}, {"p99_us", p99}, {"max_us", mx}
+        };
+        if (r.compared)
+            v["diff"] = {{"against", against.substr(3)}, {"id_switches", r.diff.switches},
+                         {"frames_differ", r.diff.frames_differ}, {"unmatched", r.diff.unmatched},
+                         {"first_diff", r.diff.frames_differ ? nlohmann::ordered_json(r.diff.first_diff)
+                                                             : nlohmann::ordered_json(nullptr)}};
+        j.push_back(v);
+    }
+    if (!report.empty()) {
+        std::ofstream f(report);
+        if (!f) { std::cerr << "cannot create " << report << "\n"; return 1; }
+        f << j.dump(2) << "\n";
+    }
+    return clean ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#include "tracker_c.h"
+#include "Tracker.hpp"
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <string>
+#include <variant>
+
+// tracker_detection / tracker_label are read and written in place as
+// Detection / Label, so their layouts must match exactly.
+static_assert(sizeof(tracker_detection) == sizeof(Detection), "detection layout");
+static_assert(offsetof(tracker_detection, y) == offsetof(Detection, y), "detection layout");
+static_assert(offsetof(tracker_detection, h) == offsetof(Detection, h), "detection layout");
+static_assert(sizeof(tracker_label) == sizeof(Label), "label layout");
+static_assert(offsetof(tracker_label, track_id) == offsetof(Label, track_id), "label layout");
+static_assert(offsetof(tracker_label, det) == offsetof(Label, det), "label layout");
+
+struct tracker
+{
+    std::variant<TrackerD, TrackerF> impl;
+};
+
+extern "C" {
+
+int tracker_abi_version(void) { return TRACKER_ABI_VERSION; }
+
+void tracker_params_default(tracker_params* p)
+{
+    if (!p) return;
+    p->max_dist         = 0.15;
+    p->max_age          = 5;
+    p->alpha            = 0.7;
+    p->assigner         = TRACKER_ASSIGN_DENSE;
+    p->warm_start       = 1;
+    p->fast_iou         = 0.7;
+    p->single_precision = 0;
+}
+
+tracker* tracker_create(const tracker_params* p)
+{
+    tracker_params d;
+    tracker_params_default(&d);
+    if (!p) p = &d;
+    if (!(p->max_dist > 0.0) || p->max_age < 0 || !(p->alpha >= 0.0 && p->alpha <= 1.0) ||
+        p->assigner < TRACKER_ASSIGN_DENSE || p->assigner > TRACKER_ASSIGN_CASCADE)
+        return nullptr;
+
+    const Assigner as = p->assigner == TRACKER_ASSIGN_SPARSE  ? Assigner::Sparse
+                      : p->assigner == TRACKER_ASSIGN_CASCADE ? Assigner::Cascade
+                      :                                         Assigner::Dense;
+    try {
+        if (p->single_precision)
+            return new tracker{std::variant<TrackerD, TrackerF>(std::in_place_type<TrackerF>,
+                               p->max_dist, p->max_age, p->alpha, as, p->warm_start != 0, p->fast_iou)};
+        return new tracker{std::variant<TrackerD, TrackerF>(std::in_place_type<TrackerD>,
+                           p->max_dist, p->max_age, p->alpha, as, p->warm_start != 0, p->fast_iou)};
+    }
+    catch (...) { return nullptr; }
+}
+
+void tracker_destroy(tracker* t) { delete t; }
+
+int tracker_step(tracker* t, double ts,
+                 const tracker_detection* dets, size_t n,
+                 tracker_label* labels, size_t capacity, size_t* n_labels)
+{
+    if (!t || (n && (!dets || !labels)) || !n_labels) return TRACKER_EINVAL;
+    *n_labels = 0;
+    if (capacity < n) return TRACKER_ENOSPC;
+    try {
+        const Detection* in  = reinterpret_cast<const Detection*>(dets);
+        Label*           out = reinterpret_cast<Label*>(labels);
+        *n_labels = std::visit([&](auto& tr){ return tr.step(ts, in, n, out); }, t->impl);
+        return TRACKER_OK;
+    }
+    catch (...) { return TRACKER_EFAIL; }
+}
+
+size_t tracker_track_count(const tracker* t)
+{
+    if (!t) return 0;
+    return std::visit([](const auto& tr){ return tr.tracks().size(); }, t->impl);
+}
+
+int tracker_set_max_tracks(tracker* t, size_t max_tracks)
+{
+    if (!t || max_tracks > UINT32_MAX) return TRACKER_EINVAL;
+    try {
+        std::visit([&](auto& tr){ tr.set_track_limit(max_tracks); }, t->impl);
+        return TRACKER_OK;
+    }
+    catch (...) { return TRACKER_EFAIL; }
+}
+
+int tracker_save(const tracker* t, void* buf, size_t capacity, size_t* size)
+{
+    if (!t || !size || (capacity && !buf)) return TRACKER_EINVAL;
+    try {
+        std::ostringstream out;
+        std::visit([&](const auto& tr){ tr.save(out); }, t->impl);
+        const std::string s = out.str();
+        *size = s.size();
+        if (capacity < s.size()) return TRACKER_ENOSPC;
+        std::memcpy(buf, s.data(), s.size());
+        return TRACKER_OK;
+    }
+    catch (...) { return TRACKER_EFAIL; }
+}
+
+int tracker_restore(tracker* t, const void* buf, size_t size)
+{
+    if (!t || (size && !buf)) return TRACKER_EINVAL;
+    try {
+        std::istringstream in(std::string(static_cast<const char*>(buf), size));
+        std::visit([&](auto& tr){ tr.restore(in); }, t->impl);
+        return TRACKER_OK;
+    }
+    catch (const std::bad_alloc&) { return TRACKER_EFAIL; }
+    catch (...) { return TRACKER_EINVAL; }
+}
+
+const char* tracker_strerror(int status)
+{
+    switch (status) {
+    case TRACKER_OK:     return "ok";
+    case TRACKER_EINVAL: return "invalid argument";
+    case TRACKER_ENOSPC: return "label buffer too small";
+    case TRACKER_EFAIL:  return "internal error";
+    default:             return "unknown status";
+    }
+}
+
+} // extern "C"